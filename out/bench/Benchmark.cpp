@@ -0,0 +1,287 @@
+// Benchmark.cpp : microbenchmark and scaling suite for the kinematics kernels and the newton solver.
+//                 Builds as the ik_bench target; every run is reproducible from its seed.
+
+#include "../include/InitialGuess.h"
+#include "../include/AllocationTracker.h"
+#include "../include/CollisionScene.h"
+#include "../include/KinematicState.h"
+#include "../include/ThreadPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+// command line configuration
+struct BenchConfig
+{
+    int minJoints = 2;
+    int maxJoints = 1024;
+    int targets = 64;             // random reachable targets per chain length
+    unsigned long long seed = 42;
+    double minSeconds = 0.05;     // minimum measured time per kernel
+    std::string jsonPath;         // empty writes no json
+    unsigned threads = 1;         // kinematics threads for long chains; one keeps the serial kernels
+    StepControl stepControl = StepControl::Full;
+    JacobianReuse jacobianReuse;
+    Termination termination;
+    int obstacles = 5000;         // circles and boxes scattered over the reach for the collision timings; zero skips them
+};
+
+// results for a single chain length
+struct BenchResult
+{
+    int joints = 0;
+    double fkNs = 0, jacobianNs = 0, stepNs = 0, solveNs = 0;
+    double tailEditFkNs = 0;              // KinematicState end effector read after changing the last joint
+    double collisionNs = 0, allPairsCollisionNs = 0; // ChainCollider::detect through the spatial hash, and against every obstacle
+    double solvesPerSecond = 0, iterationsPerSolve = 0, evaluationsPerSolve = 0, jacobiansPerSolve = 0, successRate = 0, allocationsPerSolve = 0;
+    AllocationSnapshot solveAllocations; // per phase totals over all solves; phases other than "other" need IK_TRACK_ALLOCATIONS
+};
+
+// runs the operation repeatedly until at least minSeconds have passed and returns ns per call
+template <typename Op>
+static double timeOperation(double minSeconds, Op op)
+{
+    using clock = std::chrono::steady_clock;
+    long long calls = 0;
+    long long batch = 1;
+    auto start = clock::now();
+    double elapsed = 0;
+
+    while (elapsed < minSeconds)
+    {
+        for (long long i = 0; i < batch; i++) op(i);
+        calls += batch;
+        batch *= 2;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    return elapsed * 1e9 / calls;
+}
+
+// keeps results alive so the optimizer cannot drop the measured work
+static volatile double sink;
+
+// contact detection for the chain among random obstacles over its reach, through the built hash and through an unbuilt copy
+// of the same scene, which tests every obstacle; both must find the same contacts. The scene has its own generator so the
+// targets of every chain length stay the same with or without it
+static void benchmarkCollisions(const BenchConfig& config, const std::vector<double>& lengths, const std::vector<Eigen::VectorXd>& configurations, BenchResult& result)
+{
+    std::mt19937_64 rng(config.seed + lengths.size());
+    double reach = 0.0;
+    for (double l : lengths) reach += l;
+    std::uniform_real_distribution<double> positionDist(-reach, reach), sizeDist(0.05, 0.3);
+
+    CollisionScene scene;
+    for (int i = 0; i < config.obstacles; i++)
+    {
+        const Eigen::Vector2d center(positionDist(rng), positionDist(rng));
+        const double size = sizeDist(rng);
+        if (i % 2) scene.addCircle(center, size);
+        else scene.addBox(center - Eigen::Vector2d::Constant(size), center + Eigen::Vector2d::Constant(size));
+    }
+    CollisionScene allPairs = scene;
+    scene.build();
+
+    const int joints = static_cast<int>(lengths.size());
+    const int n = static_cast<int>(configurations.size());
+    ChainCollider hashed(&scene, joints, 0.05, false), exhaustive(&allPairs, joints, 0.05, false);
+    for (const Eigen::VectorXd& q : configurations)
+    {
+        if (hashed.detect(lengths, q) != exhaustive.detect(lengths, q)) std::cerr << "Hashed and all-pairs collision detection disagree at " << joints << " joints.\n";
+    }
+
+    result.collisionNs = timeOperation(config.minSeconds, [&](long long i) {
+        sink = hashed.detect(lengths, configurations[i % n]);
+    });
+    result.allPairsCollisionNs = timeOperation(config.minSeconds, [&](long long i) {
+        sink = exhaustive.detect(lengths, configurations[i % n]);
+    });
+}
+
+static BenchResult benchmarkChain(const BenchConfig& config, int joints, std::mt19937_64& rng, ThreadPool* pool)
+{
+    std::uniform_real_distribution<double> lengthDist(0.5, 1.5);
+    std::uniform_real_distribution<double> angleDist(-M_PI, M_PI);
+
+    std::vector<double> lengths(joints);
+    for (double& l : lengths) l = lengthDist(rng);
+
+    MechanismModel mechanism(lengths);
+    MechanismModel* m = &mechanism;
+    IterativeSolver solver;
+    solver.setVerbose(false);
+    solver.setThreadPool(pool);
+    solver.setStepControl(config.stepControl);
+    solver.setJacobianReuse(config.jacobianReuse);
+    solver.setTermination(config.termination);
+
+    // targets are forward kinematics of random configurations so each one is reachable
+    std::vector<Eigen::VectorXd> configurations(config.targets, Eigen::VectorXd(joints));
+    std::vector<Coord2D> targets;
+    for (Eigen::VectorXd& q : configurations)
+    {
+        for (int i = 0; i < joints; i++) q[i] = angleDist(rng);
+        Eigen::Vector2d p = solver.endEffectorPosition(m, q);
+        targets.emplace_back(p[0], p[1]);
+    }
+
+    BenchResult result;
+    result.joints = joints;
+    const int n = config.targets;
+
+    result.fkNs = timeOperation(config.minSeconds, [&](long long i) {
+        sink = solver.endEffectorPosition(m, configurations[i % n])[0];
+    });
+
+    result.jacobianNs = timeOperation(config.minSeconds, [&](long long i) {
+        sink = solver.computeJacobian(m, configurations[i % n])(0, 0);
+    });
+
+    Eigen::MatrixXd J = solver.computeJacobian(m, configurations[0]);
+    Eigen::Vector2d e(0.1, -0.1);
+    result.stepNs = timeOperation(config.minSeconds, [&](long long) {
+        Eigen::VectorXd increment = J.colPivHouseholderQr().solve(e);
+        sink = increment[0];
+    });
+
+    KinematicState state(lengths, configurations[0]);
+    result.tailEditFkNs = timeOperation(config.minSeconds, [&](long long i) {
+        state.setJointAngle(joints - 1, configurations[i % n][joints - 1]);
+        sink = state.endEffector()[0];
+    });
+
+    if (config.obstacles > 0) benchmarkCollisions(config, lengths, configurations, result);
+
+    // full solves from the production seed, each target solved once
+    long long iterations = 0, evaluations = 0, jacobians = 0, converged = 0;
+    AllocationTracker::reset();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int t = 0; t < n; t++)
+    {
+        Eigen::VectorXd initialGuess = optimizeInitialGuess(m, targets[t]);
+        SolveResult solve = solver.newtonSolve(m, initialGuess, targets[t], 1e-6, 1e-6);
+
+        iterations += solve.iterations;
+        evaluations += solve.evaluations;
+        jacobians += solve.jacobians;
+        if (solve.converged()) converged++;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.solveAllocations = AllocationTracker::snapshot();
+
+    result.solveNs = seconds * 1e9 / n;
+    result.solvesPerSecond = n / seconds;
+    result.iterationsPerSolve = static_cast<double>(iterations) / n;
+    result.evaluationsPerSolve = static_cast<double>(evaluations) / n;
+    result.jacobiansPerSolve = static_cast<double>(jacobians) / n;
+    result.successRate = static_cast<double>(converged) / n;
+    result.allocationsPerSolve = static_cast<double>(result.solveAllocations.totalAllocations()) / n;
+
+    return result;
+}
+
+static std::string toJson(const BenchConfig& config, const std::vector<BenchResult>& results)
+{
+    std::ostringstream out;
+    out << "{\n  \"seed\": " << config.seed << ",\n  \"targets\": " << config.targets << ",\n  \"obstacles\": " << config.obstacles << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult& r = results[i];
+        out << "    {\"joints\": " << r.joints
+            << ", \"fk_ns\": " << r.fkNs
+            << ", \"jacobian_ns\": " << r.jacobianNs
+            << ", \"step_ns\": " << r.stepNs
+            << ", \"tail_edit_fk_ns\": " << r.tailEditFkNs
+            << ", \"collision_ns\": " << r.collisionNs
+            << ", \"all_pairs_collision_ns\": " << r.allPairsCollisionNs
+            << ", \"solve_ns\": " << r.solveNs
+            << ", \"solves_per_sec\": " << r.solvesPerSecond
+            << ", \"iterations_per_solve\": " << r.iterationsPerSolve
+            << ", \"fk_evaluations_per_solve\": " << r.evaluationsPerSolve
+            << ", \"jacobians_per_solve\": " << r.jacobiansPerSolve
+            << ", \"success_rate\": " << r.successRate
+            << ", \"allocations_per_solve\": " << r.allocationsPerSolve
+            << ", \"allocations_by_phase\": {";
+        for (int p = 0; p < static_cast<int>(AllocationPhase::Count); p++)
+        {
+            out << (p ? ", " : "") << "\"" << AllocationTracker::phaseName(static_cast<AllocationPhase>(p)) << "\": "
+                << static_cast<double>(r.solveAllocations.allocations[p]) / config.targets;
+        }
+        out << "}}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+static bool parseArguments(int argc, char** argv, BenchConfig& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--min-joints" && hasValue) config.minJoints = std::atoi(argv[++i]);
+        else if (arg == "--max-joints" && hasValue) config.maxJoints = std::atoi(argv[++i]);
+        else if (arg == "--targets" && hasValue) config.targets = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--min-time" && hasValue) config.minSeconds = std::atof(argv[++i]);
+        else if (arg == "--json" && hasValue) config.jsonPath = argv[++i];
+        else if (arg == "--threads" && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--step-control" && hasValue && parseStepControl(argv[i + 1], config.stepControl)) i++;
+        else if (arg == "--jacobian" && hasValue && parseJacobianUpdate(argv[i + 1], config.jacobianReuse.mode)) i++;
+        else if (arg == "--refresh-interval" && hasValue) config.jacobianReuse.refreshInterval = std::atoi(argv[++i]);
+        else if (arg == "--max-iterations" && hasValue) config.termination.maxIterations = std::atoi(argv[++i]);
+        else if (arg == "--obstacles" && hasValue) config.obstacles = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "usage: ik_bench [--min-joints N] [--max-joints N] [--targets N] [--seed S] [--min-time SECONDS] [--json FILE] [--threads N] [--step-control full|line-search|trust-region] [--jacobian exact|broyden|chord] [--refresh-interval K] [--max-iterations N] [--obstacles N]\n";
+            return false;
+        }
+    }
+
+    return config.minJoints >= 1 && config.maxJoints >= config.minJoints && config.targets >= 1 && config.jacobianReuse.refreshInterval >= 1 && config.termination.maxIterations >= 1 && config.obstacles >= 0;
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    std::mt19937_64 rng(config.seed);
+    std::vector<BenchResult> results;
+    std::unique_ptr<ThreadPool> pool;
+    if (config.threads != 1) pool = std::make_unique<ThreadPool>(config.threads); // zero means one per hardware thread
+
+    std::printf("%8s %12s %12s %12s %12s %12s %14s %14s %12s %10s %10s %10s %9s %12s\n",
+        "joints", "fk ns", "tail fk ns", "jacobian ns", "step ns", "collide ns", "all-pairs ns", "solve ns", "solves/s", "iter/solve", "fk/solve", "jac/solve", "success", "allocs/solve");
+
+    for (int joints = config.minJoints; joints <= config.maxJoints; joints *= 2) // chain lengths double from the minimum
+    {
+        BenchResult r = benchmarkChain(config, joints, rng, pool.get());
+        results.push_back(r);
+
+        std::printf("%8d %12.1f %12.1f %12.1f %12.1f %12.1f %14.1f %14.1f %12.1f %10.2f %10.2f %10.2f %8.1f%% %12.1f\n",
+            r.joints, r.fkNs, r.tailEditFkNs, r.jacobianNs, r.stepNs, r.collisionNs, r.allPairsCollisionNs, r.solveNs, r.solvesPerSecond, r.iterationsPerSolve, r.evaluationsPerSolve, r.jacobiansPerSolve, 100.0 * r.successRate, r.allocationsPerSolve);
+    }
+
+    if (!config.jsonPath.empty())
+    {
+        std::ofstream file(config.jsonPath);
+        if (!file)
+        {
+            std::cerr << "Could not open " << config.jsonPath << " for writing.\n";
+            return 1;
+        }
+        file << toJson(config, results);
+    }
+
+    return 0;
+}
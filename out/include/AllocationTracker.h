@@ -0,0 +1,80 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstddef>
+#include <iostream>
+
+// solver phases that allocations are attributed to
+enum class AllocationPhase
+{
+    Other,
+    ForwardKinematics,
+    Jacobian,
+    LinearSolve,
+    History,
+    Count
+};
+
+// allocation counts and bytes per phase since the last reset
+struct AllocationSnapshot
+{
+    long long allocations[static_cast<int>(AllocationPhase::Count)] = {};
+    long long bytes[static_cast<int>(AllocationPhase::Count)] = {};
+    long long violations = 0; // allocations made inside a no-allocation region
+
+    long long totalAllocations() const;
+    long long totalBytes() const;
+};
+
+// this class collects allocation statistics fed by the allocation hooks in AllocationHooks.cpp
+// the hooks are only linked into targets built with IK_TRACK_ALLOCATIONS (and always into ik_bench and ik_test_allocations)
+class AllocationTracker
+{
+    public:
+        static void recordAllocation(std::size_t size); // called from operator new
+
+        static AllocationSnapshot snapshot();
+        static void reset();
+        static void report(std::ostream& out, const AllocationSnapshot& s);
+        static const char* phaseName(AllocationPhase phase);
+
+        // assert mode aborts on the first allocation inside a no-allocation region; otherwise violations are only counted
+        static void setAbortOnViolation(bool enabled);
+
+        static AllocationPhase currentPhase();
+        static void setCurrentPhase(AllocationPhase phase);
+        static void enterNoAllocationRegion(const char* name);
+        static void leaveNoAllocationRegion();
+};
+
+// attributes allocations on this thread to a phase until the end of the scope
+class AllocationPhaseScope
+{
+    private:
+        AllocationPhase previous;
+    public:
+        explicit AllocationPhaseScope(AllocationPhase phase) : previous(AllocationTracker::currentPhase()) { AllocationTracker::setCurrentPhase(phase); }
+        ~AllocationPhaseScope() { AllocationTracker::setCurrentPhase(previous); }
+};
+
+// marks a hot region that must not allocate on this thread
+class NoAllocationScope
+{
+    public:
+        explicit NoAllocationScope(const char* name) { AllocationTracker::enterNoAllocationRegion(name); }
+        ~NoAllocationScope() { AllocationTracker::leaveNoAllocationRegion(); }
+};
+
+// the macros compile away entirely unless allocation tracking is enabled
+#define IK_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define IK_ALLOCATION_CONCAT(a, b) IK_ALLOCATION_CONCAT_INNER(a, b)
+
+#ifdef IK_TRACK_ALLOCATIONS
+    #define IK_ALLOCATION_PHASE(phase) AllocationPhaseScope IK_ALLOCATION_CONCAT(allocationPhase, __LINE__)(AllocationPhase::phase)
+    #define IK_NO_ALLOCATION_REGION(name) NoAllocationScope IK_ALLOCATION_CONCAT(noAllocation, __LINE__)(name)
+#else
+    #define IK_ALLOCATION_PHASE(phase) ((void)0)
+    #define IK_NO_ALLOCATION_REGION(name) ((void)0)
+#endif
+
+#endif // ALLOCATIONTRACKER_H
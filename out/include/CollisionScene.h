@@ -0,0 +1,153 @@
+#ifndef COLLISIONSCENE_H
+#define COLLISIONSCENE_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+// axis aligned bounding box
+struct Aabb
+{
+    Eigen::Vector2d min, max;
+
+    bool overlaps(const Aabb& other) const
+    {
+        return min.x() <= other.max.x() && other.min.x() <= max.x() && min.y() <= other.max.y() && other.min.y() <= max.y();
+    }
+};
+
+// a static obstacle in the plane; boxes are stored as four vertex polygons
+struct Obstacle
+{
+    enum class Shape { Circle, Polygon };
+
+    Shape shape = Shape::Circle;
+    Eigen::Vector2d center = Eigen::Vector2d::Zero(); // circle center, or polygon centroid
+    double radius = 0.0;
+    std::vector<Eigen::Vector2d> vertices;            // convex, counter-clockwise
+    Aabb bounds;
+};
+
+// this class holds the obstacles of a work cell and a spatial hash over them for the broad phase
+// every obstacle is entered into each grid cell its bounding box covers; the cells are hashed into a fixed table stored as
+// one flat array of obstacle indices with per-bucket offsets, so a query touches only the buckets under its box
+// obstacles are added first and build() is called once; after that the scene is read only and may be shared between threads
+class CollisionScene
+{
+    private:
+        std::vector<Obstacle> obstacles;
+        double cellSize;
+        std::vector<int> bucketStart; // bucketStart[b] .. bucketStart[b + 1] index into entries
+        std::vector<int> entries;     // obstacle indices grouped by bucket
+        bool built;
+
+        std::size_t bucketOf(long long cellX, long long cellY) const;
+        long long cellCoordinate(double value) const;
+
+    public:
+        CollisionScene();
+
+        int addCircle(const Eigen::Vector2d& center, double radius);
+        int addBox(const Eigen::Vector2d& min, const Eigen::Vector2d& max);
+        int addPolygon(const std::vector<Eigen::Vector2d>& vertices); // convex, either winding
+
+        // builds the hash; a cell size of zero uses the mean obstacle extent
+        void build(double gridCellSize = 0.0);
+
+        int getObstacleCount() const;
+        const Obstacle& getObstacle(int index) const;
+        bool isBuilt() const;
+
+        // calls visit(index) once for every obstacle whose box may overlap the query box
+        // stamps must hold one entry per obstacle and stamp must differ from every value stored in it; the caller owns both
+        // so concurrent queries on a shared scene need no locking
+        template <typename Visit>
+        void query(const Aabb& box, std::vector<unsigned>& stamps, unsigned stamp, Visit visit) const;
+};
+
+// a penetration of a link's swept circle (capsule) into an obstacle or another link
+struct Contact
+{
+    int link = 0;
+    int other = -1;                                   // obstacle index, or the other link for self collisions
+    bool selfCollision = false;
+    Eigen::Vector2d point = Eigen::Vector2d::Zero();  // on the link's center line
+    Eigen::Vector2d normal = Eigen::Vector2d::Zero(); // unit direction that separates the link
+    double depth = 0.0;
+};
+
+// this class finds the contacts of one chain against a scene and turns them into a penalty gradient for the solver
+// the links are capsules of the given radius; self collision between links that do not share a joint is found by
+// sweep and prune on the x axis, with the sort order kept between calls so the nearly sorted insertion sort stays O(n)
+// all scratch buffers are sized on construction and detection never allocates: a chain keeps at most 4 contacts per link plus
+// 16, and beyond that only the deepest ones
+class ChainCollider
+{
+    private:
+        const CollisionScene* scene;
+        double linkRadius;
+        bool selfCollision;
+
+        std::vector<Eigen::Vector2d> joints;          // joint positions; joints[n] is the end effector
+        std::vector<Aabb> linkBounds;
+        std::vector<int> sweepOrder;                  // link indices sorted by linkBounds min x
+        std::vector<unsigned> stamps;                 // broad phase deduplication, one per obstacle
+        unsigned stamp;
+        std::vector<Contact> contacts;
+        std::vector<Eigen::Vector3d> linkLoads;       // per link force x, force y, torque about the origin
+
+        void resize(int linkCount);
+        int detectContacts(int linkCount);
+        void detectObstacles(int linkCount);
+        void detectSelfCollisions(int linkCount);
+        void addContact(const Contact& contact);
+
+    public:
+        ChainCollider(const CollisionScene* collisionScene, int linkCount, double capsuleRadius, bool checkSelfCollision = true);
+
+        // finds every contact for the configuration whose jacobian (IterativeSolver::jacobianKernel layout) is J
+        int detect(const double* J, int linkCount);
+        int detect(const std::vector<double>& links, const Eigen::VectorXd& jointAngles);
+
+        const std::vector<Contact>& getContacts() const;
+        double totalPenetration() const;
+
+        // adds weight times the descent direction of 1/2 sum depth^2 to z in O(n + contacts), counting each self collision pair once:
+        // each contact pushes its point along its normal, and the joint torques are suffix sums of those pushes
+        void addPenaltyGradient(double weight, double* z);
+};
+
+template <typename Visit>
+void CollisionScene::query(const Aabb& box, std::vector<unsigned>& stamps, unsigned stamp, Visit visit) const
+{
+    if (obstacles.empty()) return;
+
+    const long long x0 = cellCoordinate(box.min.x()), x1 = cellCoordinate(box.max.x());
+    const long long y0 = cellCoordinate(box.min.y()), y1 = cellCoordinate(box.max.y());
+
+    // a box covering more cells than there are obstacles is cheaper to test against every obstacle
+    if (!built || (x1 - x0 + 1) * (y1 - y0 + 1) > static_cast<long long>(obstacles.size()))
+    {
+        for (int i = 0; i < static_cast<int>(obstacles.size()); i++)
+        {
+            if (obstacles[i].bounds.overlaps(box)) visit(i);
+        }
+        return;
+    }
+
+    for (long long cx = x0; cx <= x1; cx++)
+    {
+        for (long long cy = y0; cy <= y1; cy++)
+        {
+            const std::size_t bucket = bucketOf(cx, cy);
+            for (int e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++)
+            {
+                const int i = entries[e];
+                if (stamps[i] == stamp) continue; // already seen through another cell, or another cell hashed to this bucket
+                stamps[i] = stamp;
+                if (obstacles[i].bounds.overlaps(box)) visit(i);
+            }
+        }
+    }
+}
+
+#endif // COLLISIONSCENE_H
@@ -0,0 +1,62 @@
+#ifndef COMPILEDMECHANISM_H
+#define COMPILEDMECHANISM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "MechanismModel.h"
+
+const std::size_t cacheLineBytes = 64;
+
+// this class is the immutable, solver-ready form of a mechanism
+// it is compiled once from a MechanismModel and never changes afterwards, so any number of solver threads may share one
+// instance through a const reference or a shared_ptr<const CompiledMechanism> without locks or copies. Per-link data lives
+// in separate cache-line-aligned arrays (structure of arrays), one quantity per array, and the workspace invariants the
+// solvers keep recomputing (reach, cumulative lengths) are computed here once
+class alignas(cacheLineBytes) CompiledMechanism
+{
+    private:
+        struct AlignedDelete
+        {
+            void operator()(double* data) const;
+        };
+
+        int joints;
+        double reach;                   // sum of the link lengths
+        double innerReach;              // radius of the unreachable disc around the base; zero when the chain folds onto it
+        std::uint64_t fingerprint;
+        std::unique_ptr<double, AlignedDelete> storage; // the arrays below, each starting on a cache line
+        const double* lengths;
+        const double* cumulativeLengths;
+        const double* remainingReach;
+        MechanismModel model;           // for the solver entry points that take a model; never handed out mutable
+
+    public:
+        explicit CompiledMechanism(const std::vector<double>& links);
+        explicit CompiledMechanism(const MechanismModel& mechanism);
+
+        CompiledMechanism(const CompiledMechanism&) = delete;
+        CompiledMechanism& operator=(const CompiledMechanism&) = delete;
+
+        // shared, immutable handle; the usual way to pass a mechanism to several threads
+        static std::shared_ptr<const CompiledMechanism> compile(const std::vector<double>& links);
+
+        int getJoints() const;
+        const double* getLinks() const;             // joints lengths
+        const double* getCumulativeLengths() const; // [i] is the distance along the chain from the base to the end of link i
+        const double* getRemainingReach() const;    // [i] is the combined length of links i to the last
+        double getReach() const;
+        double getInnerReach() const;
+        const MechanismModel& getModel() const;
+
+        // FNV-1a over the joint count and the exact bit patterns of the lengths, taken in a fixed byte order, so it is the
+        // same in every process and on every run; equal link lengths always give equal fingerprints
+        std::uint64_t getFingerprint() const;
+        bool sameLinks(const CompiledMechanism& other) const; // exact comparison, for when a fingerprint match must be confirmed
+
+        bool isOutOfReach(const Coord2D& point) const;  // farther than the fully extended chain
+        bool isReachable(const Coord2D& point) const;   // inside the workspace annulus
+};
+
+#endif // COMPILEDMECHANISM_H
@@ -4,7 +4,8 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
-#include "gui.h"
+
+class GUI; // only the input readers in GuiInput.cpp need the full definition
 
 // the CoordinateSystem class exists to define a base coordinate system that allows for expansion of dimensions
 class CoordinateSystem 
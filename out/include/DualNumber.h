@@ -0,0 +1,88 @@
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include <cmath>
+#include <Eigen/Dense>
+
+// this class defines a forward-mode dual number that carries one derivative per seeded direction
+// seeding joint i with the i-th unit direction lets a single forward kinematics pass produce every jacobian column at once
+template <int Directions = Eigen::Dynamic>
+class DualNumber
+{
+	public:
+		typedef Eigen::Array<double, Directions, 1> Derivatives;
+
+		double value;
+		Derivatives derivatives; // partial derivatives with respect to each seeded direction
+
+		// constructors
+		DualNumber() : value(0.0) {}
+		DualNumber(double v, int directions) : value(v), derivatives(Derivatives::Zero(directions)) {}
+		DualNumber(double v, const Derivatives& d) : value(v), derivatives(d) {}
+
+		// creates an independent variable whose derivative is the unit vector along the given direction
+		static DualNumber variable(double v, int direction, int directions)
+		{
+			DualNumber result(v, directions);
+			result.derivatives[direction] = 1.0;
+			return result;
+		}
+
+		DualNumber& operator+=(const DualNumber& other)
+		{
+			value += other.value;
+			derivatives += other.derivatives;
+			return *this;
+		}
+
+		DualNumber& operator-=(const DualNumber& other)
+		{
+			value -= other.value;
+			derivatives -= other.derivatives;
+			return *this;
+		}
+
+		DualNumber& operator*=(double s)
+		{
+			value *= s;
+			derivatives *= s;
+			return *this;
+		}
+};
+
+template <int D>
+DualNumber<D> operator+(DualNumber<D> a, const DualNumber<D>& b) { return a += b; }
+
+template <int D>
+DualNumber<D> operator-(DualNumber<D> a, const DualNumber<D>& b) { return a -= b; }
+
+template <int D>
+DualNumber<D> operator-(const DualNumber<D>& a) { return DualNumber<D>(-a.value, -a.derivatives); }
+
+template <int D>
+DualNumber<D> operator*(DualNumber<D> a, double s) { return a *= s; }
+
+template <int D>
+DualNumber<D> operator*(double s, DualNumber<D> a) { return a *= s; }
+
+// product rule
+template <int D>
+DualNumber<D> operator*(const DualNumber<D>& a, const DualNumber<D>& b)
+{
+	return DualNumber<D>(a.value * b.value, a.derivatives * b.value + b.derivatives * a.value);
+}
+
+// chain rule for the trig functions used by the kinematics; found through argument dependent lookup
+template <int D>
+DualNumber<D> sin(const DualNumber<D>& a)
+{
+	return DualNumber<D>(std::sin(a.value), a.derivatives * std::cos(a.value));
+}
+
+template <int D>
+DualNumber<D> cos(const DualNumber<D>& a)
+{
+	return DualNumber<D>(std::cos(a.value), a.derivatives * -std::sin(a.value));
+}
+
+#endif // DUALNUMBER_H
@@ -0,0 +1,12 @@
+#ifndef INITIALGUESS_H
+#define INITIALGUESS_H
+
+#include "IterativeSolver.h"
+#ifndef M_PI
+	#define M_PI 3.14159265358979323846
+#endif
+
+// computes a starting configuration for newton's method from the quadrant of the desired point
+Eigen::VectorXd optimizeInitialGuess(const MechanismModel* m, Coord2D point);
+
+#endif // INITIALGUESS_H
@@ -2,9 +2,6 @@
 // or project specific include files.
 
 #include "IterativeSolver.h"
-#include "gui.h"
-#ifndef M_PI
-	#define M_PI 3.14159265358979323846
-#endif
-
-Eigen::VectorXd optimizeInitialGuess(MechanismModel* m, Coord2D point);
\ No newline at end of file
+#include "InitialGuess.h"
+#include "Profiler.h"
+#include "gui.h"
\ No newline at end of file
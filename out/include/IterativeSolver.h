@@ -3,19 +3,205 @@
 
 #include <Eigen/Dense>
 #include "MechanismModel.h"
+#include "CompiledMechanism.h"
+#include "DualNumber.h"
+#include "SolverWorkspace.h"
+#include "SecondaryObjectives.h"
+#include "SolveTrace.h"
+#include <limits>
+#include <string>
+
+class ThreadPool;
+
+// default joint model: joint i rotates its link by exactly its own coordinate
+// custom joint models (cams, couplings) supply their own operator() returning the relative rotation of joint i
+struct RevoluteJointModel
+{
+	template <typename Angles>
+	auto operator()(int i, const Angles& q) const { return q[i]; }
+};
+
+// outcome of a solve
+enum class SolveStatus
+{
+	Converged,       // error below tolerance
+	BudgetExhausted, // time or iteration budget ran out first; the best iterate is still returned
+	Diverging,       // the bounded solver went a whole divergence window without improving on its best error
+	Running,         // a NewtonStepper that has not finished yet
+	// early exits for solves that are not going to converge; appended so the values already sent over the solve service keep their meaning
+	StepTooSmall,    // a step shorter than deltaTolerance failed to halve the error: a stationary point that is not a solution
+	Stalled,         // the best error fell by less than stallImprovement over stallWindow iterations
+	Oscillating,     // the error went up and down for oscillationWindow iterations in a row without a significant new best
+	NonFinite,       // the error became NaN or infinite; the last finite iterate is kept
+	Unreachable      // the target lies outside the workspace annulus, so no solve was attempted and the guess is returned as it was
+};
+
+// how much of each newton step is taken
+enum class StepControl
+{
+	Full,        // always the whole step
+	LineSearch,  // backtracking (armijo): halve the step until the squared error drops by a sufficient fraction
+	TrustRegion  // dogleg between the steepest descent and newton steps, inside a radius that adapts to how well the model predicted
+};
+
+// reads "full", "line-search" or "trust-region" into control; false, leaving control untouched, for any other name
+bool parseStepControl(const std::string& name, StepControl& control);
+
+// where the jacobian of each newton step comes from
+enum class JacobianUpdate
+{
+	Exact,   // a fresh jacobian every iteration
+	Broyden, // rank-1 secant updates from the observed end effector motion between refreshes
+	Chord    // the last fresh jacobian is reused until the next refresh (shamanskii when the interval is greater than one)
+};
+
+// reads "exact", "broyden" or "chord" into mode; false, leaving mode untouched, for any other name
+bool parseJacobianUpdate(const std::string& name, JacobianUpdate& mode);
+
+// jacobian reuse settings; every mode refreshes on the first iteration, every refreshInterval iterations, and after any
+// iteration that fails to shrink the error by slowdownRatio, so a stale jacobian cannot stall the solve
+struct JacobianReuse
+{
+	JacobianUpdate mode = JacobianUpdate::Exact;
+	int refreshInterval = 8;
+	double slowdownRatio = 0.5;
+};
+
+// when newtonSolve gives up on a solve; every exit has its own SolveStatus. The step length threshold is newtonSolve's deltaTolerance
+// a window of zero switches its check off. Full steps often bounce around for a while before they settle into convergence, so they
+// are watched over their own, longer windows; line search and trust region steps use stallWindow and oscillationWindow
+struct Termination
+{
+	int maxIterations = 1000;
+	int stallWindow = 16;
+	double stallImprovement = 0.01; // relative decrease of the best error each stall window has to achieve
+	int oscillationWindow = 8;
+	int fullStepStallWindow = 64;
+	int fullStepOscillationWindow = 16;
+};
+
+// result of newtonSolve; the answer alone unless a trace was asked for
+struct SolveResult
+{
+	SolveStatus status = SolveStatus::BudgetExhausted;
+	Eigen::VectorXd solution; // final iterate
+	double error = std::numeric_limits<double>::infinity(); // error norm of the solution
+	int iterations = 0;       // newton steps taken
+	int evaluations = 0;      // forward kinematics evaluations, including rejected trial steps
+	int jacobians = 0;        // fresh jacobian evaluations
+	SolveTrace trace;         // every iterate with its error and step norm; empty unless recordTrace was set
+
+	bool converged() const { return status == SolveStatus::Converged; }
+};
+
+// limits for a deadline bounded solve; the solve stops before starting an iteration it cannot finish inside the time budget
+struct SolveBudget
+{
+	double seconds = std::numeric_limits<double>::infinity();
+	int iterations = 1000;
+	int divergenceWindow = 16; // iterations in a row without improving on the best error before the solve is called diverging
+};
+
+struct BoundedSolveResult
+{
+	SolveStatus status = SolveStatus::BudgetExhausted;
+	double error = std::numeric_limits<double>::infinity(); // error norm of workspace.best
+	int iterations = 0;
+};
 
 // this class defines the functions and parameters needed to implement newton's method
 class IterativeSolver
 {
 	private:
 		int id;
+		bool verbose; // prints the error norm every iteration and a summary on convergence
+		SecondaryObjectives objectives; // followed in the null space of every newton step when active
+		ThreadPool* pool; // splits forward kinematics and the jacobian of long chains; not owned
+		StepControl stepControl;
+		JacobianReuse jacobianReuse;
+		Termination termination;
+		BoundedSolveResult boundedSolve(const double* links, int joints, const Eigen::Ref<const Eigen::VectorXd>& initialGuess, Coord2D desiredPosition, double tolerance, const SolveBudget& budget, SolverWorkspace& workspace);
 	public:
 		IterativeSolver();
-		Eigen::Matrix4d constructForwardMatrix(MechanismModel* m);
+		void setVerbose(bool enabled);
+		void setSecondaryObjectives(const SecondaryObjectives& secondary); // limits and rest pose must have one entry per joint
+		void setThreadPool(ThreadPool* threadPool); // chains of parallelKinematicsMinJoints or more use the parallel scan kernels
+		void setStepControl(StepControl control);
+		StepControl getStepControl() const;
+		void setJacobianReuse(const JacobianReuse& reuse);
+		const JacobianReuse& getJacobianReuse() const;
+		void setTermination(const Termination& criteria);
+		const Termination& getTermination() const;
+		bool needsExactJacobian() const; // the active objectives read joint positions out of the jacobian, so it cannot be approximated
+		Eigen::Matrix4d constructForwardMatrix(const MechanismModel* m);
 		Eigen::Vector2d error(Eigen::Vector2d desiredPosition, Eigen::Vector2d actualPosition);
-		Eigen::Vector2d endEffectorPosition(MechanismModel* m, Eigen::VectorXd jointAngles);
-		Eigen::MatrixXd computeJacobian(MechanismModel *m, Eigen::VectorXd jointAngles);
-		std::vector<Eigen::VectorXd> newtonSolve(MechanismModel *m, Eigen::VectorXd initialGuess, Coord2D desiredPosition, double tolerance, double deltaTolerance);
+		Eigen::Vector2d endEffectorPosition(const MechanismModel* m, Eigen::VectorXd jointAngles);
+		Eigen::MatrixXd computeJacobian(const MechanismModel* m, Eigen::VectorXd jointAngles);
+		static void jacobianKernel(const double* links, const double* jointAngles, int joints, double* J); // O(n), column-major 2 x joints, no allocation
+		// one newton increment for the configuration q with error e: the QR step, or the null space step when objectives are active
+		// the jacobian it was computed from is left in J for step control
+		void computeStep(const MechanismModel* m, const Eigen::VectorXd& q, const Eigen::Vector2d& e, Eigen::MatrixXd& J, Eigen::VectorXd& increment);
+		void solveStep(const Eigen::VectorXd& q, const Eigen::MatrixXd& J, const Eigen::Vector2d& e, Eigen::VectorXd& increment); // the same for a given jacobian
+		SolveResult newtonSolve(const MechanismModel* m, Eigen::VectorXd initialGuess, Coord2D desiredPosition, double tolerance, double deltaTolerance, bool recordTrace = false);
+
+		// anytime variant of newtonSolve for real-time loops: returns within the budget with the best iterate in workspace.best
+		// does not allocate or print when the workspace matches the mechanism's joint count; the guess may map caller memory, such as a shared
+		// memory slot, without a temporary
+		BoundedSolveResult newtonSolveBounded(const MechanismModel* m, const Eigen::Ref<const Eigen::VectorXd>& initialGuess, Coord2D desiredPosition, double tolerance, const SolveBudget& budget, SolverWorkspace& workspace);
+		// the same over a compiled mechanism's aligned link array; a target outside its workspace annulus returns Unreachable with
+		// the guess in workspace.best and no iterations
+		BoundedSolveResult newtonSolveBounded(const CompiledMechanism& mechanism, const Eigen::Ref<const Eigen::VectorXd>& initialGuess, Coord2D desiredPosition, double tolerance, const SolveBudget& budget, SolverWorkspace& workspace);
+
+		// forward kinematics written once for any scalar type (double, DualNumber); x and y must be passed in as zero
+		template <typename Scalar, typename Angles, typename JointModel>
+		static void forwardKinematics(const std::vector<double>& links, const Angles& q, const JointModel& model, Scalar& x, Scalar& y);
+
+		// exact jacobian from a single dual number forward pass, for joint models without a hand derived jacobian
+		template <typename JointModel = RevoluteJointModel>
+		Eigen::MatrixXd computeJacobianAutoDiff(const MechanismModel* m, const Eigen::VectorXd& jointAngles, const JointModel& model = JointModel());
+
+		// check mode: compares the analytic jacobian against the dual number one and returns the largest deviation
+		double checkJacobian(const MechanismModel* m, const Eigen::VectorXd& jointAngles, double tolerance);
 };
 
+template <typename Scalar, typename Angles, typename JointModel>
+void IterativeSolver::forwardKinematics(const std::vector<double>& links, const Angles& q, const JointModel& model, Scalar& x, Scalar& y)
+{
+	using std::cos;
+	using std::sin;
+
+	Scalar theta = x; // zero of the right shape for the scalar type
+
+	for (int i = 0; i < static_cast<int>(links.size()); i++) // accumulate the absolute angle of each link and add its contribution
+	{
+		theta += model(i, q);
+		x += links[i] * cos(theta);
+		y += links[i] * sin(theta);
+	}
+}
+
+template <typename JointModel>
+Eigen::MatrixXd IterativeSolver::computeJacobianAutoDiff(const MechanismModel* m, const Eigen::VectorXd& jointAngles, const JointModel& model)
+{
+	typedef DualNumber<> Dual;
+
+	int joints = m->getJoints();
+
+	std::vector<Dual> seeded; // seed every joint with its own direction so one pass yields all columns
+	seeded.reserve(joints);
+	for (int i = 0; i < joints; i++)
+	{
+		seeded.push_back(Dual::variable(jointAngles[i], i, joints));
+	}
+
+	Dual x(0.0, joints), y(0.0, joints);
+	forwardKinematics(m->getLinks(), seeded, model, x, y);
+
+	Eigen::MatrixXd J(2, joints);
+	J.row(0) = x.derivatives.matrix().transpose();
+	J.row(1) = y.derivatives.matrix().transpose();
+
+	return J;
+}
+
 #endif // ITERATIVESOLVER_H
\ No newline at end of file
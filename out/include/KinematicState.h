@@ -0,0 +1,48 @@
+#ifndef KINEMATICSTATE_H
+#define KINEMATICSTATE_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+// this class caches the forward kinematics of one chain: the absolute angle of every link, its sine and cosine, and the
+// position of every joint. Changing joint k (or link k) only invalidates links k and beyond, so the cache remembers the
+// first dirty link and the next read recomputes just that suffix, O(n - k) instead of the whole chain.
+// reads refresh the cache lazily, so a const KinematicState is still not safe to read from two threads at once
+class KinematicState
+{
+    private:
+        std::vector<double> links;
+        std::vector<double> angles;
+
+        // cache, valid for links below dirtyFrom; positions hold n + 1 joints with the end effector last
+        mutable std::vector<double> absoluteAngles, cosines, sines;
+        mutable std::vector<double> positionX, positionY;
+        mutable int dirtyFrom;
+
+        void refresh() const;
+        void markDirty(int link);
+
+    public:
+        KinematicState(const std::vector<double>& linkLengths, const Eigen::VectorXd& jointAngles);
+
+        int getJoints() const;
+        double getJointAngle(int joint) const;
+        const std::vector<double>& getJointAngles() const;
+
+        void setJointAngle(int joint, double angle);
+        void setJointAngles(const Eigen::VectorXd& jointAngles); // dirties from the first joint that actually changed
+        void setLinkLength(int link, double length);
+
+        // number of links the next read will recompute; zero when the cache is current
+        int pendingLinks() const;
+
+        Eigen::Vector2d endEffector() const;
+        Eigen::Vector2d jointPosition(int joint) const; // joint 0 is the base, joint n the end effector
+        double absoluteAngle(int link) const;
+        Eigen::Vector2d linkDirection(int link) const;  // cosine and sine of the absolute angle
+
+        // writes the column-major 2 x n jacobian from the cached joint positions, without evaluating any trigonometry
+        void jacobian(double* J) const;
+};
+
+#endif // KINEMATICSTATE_H
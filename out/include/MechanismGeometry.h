@@ -0,0 +1,14 @@
+#ifndef MECHANISMGEOMETRY_H
+#define MECHANISMGEOMETRY_H
+
+#include <vector>
+
+// mechanism units to drawing coordinates: reduce size by a factor of 7 so typical mechanisms fit the -1..1 view
+const float mechanismDrawScale = 1.0f / 7.0f;
+
+// computes the base and every joint position of the mechanism once, as interleaved x, y pairs scaled into drawing coordinates
+// joints closer than minSpacing to the previously kept joint are dropped (level of detail); the base and end effector are always kept
+// the same vertices feed the links (as a line strip) and the joint dots, so nothing is computed twice
+void buildMechanismVertices(const std::vector<float>& linkLengths, const std::vector<float>& jointAngles, float scale, float minSpacing, std::vector<float>& vertices);
+
+#endif // MECHANISMGEOMETRY_H
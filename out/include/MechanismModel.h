@@ -13,12 +13,13 @@ class MechanismModel
 	    int numJoints;
 	    std::vector<double> linkLengths; // each length corresponds to link index + 1
     public:
-	    // constructor
+	    // constructors
         MechanismModel();
+        explicit MechanismModel(const std::vector<double>& lengths); // builds a mechanism directly from link lengths, one joint per link
 
         // getters
-        int getJoints();
-        std::vector<double> getLinks();
+        int getJoints() const;
+        const std::vector<double>& getLinks() const; // no copy; valid until the mechanism is re-initialized
 
         void initializeMechanism(GUI *gui);             // gets the number of joints and link lengths from the user
         bool isOutOfReach(const Coord2D& point) const; // checks if the desired point is out of reach
@@ -0,0 +1,75 @@
+#ifndef NEWTONSTEPPER_H
+#define NEWTONSTEPPER_H
+
+#include "IterativeSolver.h"
+
+// this class runs newton's method one iteration per call to step(), so the caller decides when (and whether) the next
+// iterate is computed: render or inspect each iterate as it appears, stop early, or interleave many solves on one thread
+// nothing is buffered; the stepper holds only the current iterate. How much of each newton step is taken follows the solver's
+// StepControl, and the error of the accepted trial point becomes the next iteration's error, so line search and trust region
+// only cost extra forward kinematics evaluations for rejected trials. The jacobian is computed fresh or carried over from the
+// previous iteration as the solver's JacobianReuse says. The solve ends early, each way with its own status, when a step
+// under the step tolerance makes no progress, when the best error stalls or the error oscillates for the solver's Termination
+// windows (the longer full step ones for StepControl::Full), or at once when the error turns non-finite.
+// the solver and mechanism must outlive the stepper, and a solver whose objectives carry a collider must not be stepped from
+// two threads at once
+class NewtonStepper
+{
+    private:
+        IterativeSolver& solver;
+        const MechanismModel* m;
+        Eigen::Vector2d desired;
+        double tolerance;
+        double stepTolerance;
+        Termination termination;
+
+        Eigen::VectorXd iterator;
+        Eigen::VectorXd increment; // full newton step
+        Eigen::VectorXd candidate; // step actually tried
+        Eigen::VectorXd trial;     // iterator + candidate
+        Eigen::VectorXd gradient;  // steepest descent direction J^T e, for the trust region
+        Eigen::MatrixXd J;         // jacobian at the current iterate, or its broyden or chord approximation
+        Eigen::Vector2d e;         // error at the current iterate
+        double stepLength;         // norm of the step that produced the current iterate
+        double radius;             // trust region radius in joint space, kept between steps
+        int iterations;
+        int evaluations;
+        int jacobianEvaluations;
+        int sinceRefresh;          // iterations since the jacobian was last computed fresh
+        bool refreshJacobian;      // the last iteration made too little progress with the current jacobian
+        bool freshJacobian;        // the last step came from a jacobian computed at its own iterate
+        bool nonFinite;            // a trial step produced a NaN or infinite error and was not taken
+        double bestError;
+        double stallReference;     // best error when the current stall window began
+        int stallStart;
+        int lastDirection;         // sign of the last change in the error
+        int alternations;          // consecutive reversals of that sign since the last significant new best
+        SolveStatus state;
+
+        Eigen::Vector2d errorAt(const Eigen::VectorXd& q); // one forward kinematics evaluation
+        void updateStatus(double previousNorm);
+        SolveStatus checkProgress(double norm, double previousNorm);
+        void accept(const Eigen::Vector2d& trialError);   // moves to trial, whose error is already known
+        void lineSearch();
+        void trustRegion();
+        void updateJacobian(const Eigen::Vector2d& previousError);
+
+    public:
+        // a step shorter than deltaTolerance that fails to halve the error ends the solve; zero never stops on short steps
+        // the iteration cap and the stall and oscillation windows come from the solver's Termination
+        NewtonStepper(IterativeSolver& iterativeSolver, const MechanismModel* mechanism, const Eigen::VectorXd& initialGuess, Coord2D desiredPosition, double errorTolerance, double deltaTolerance = 0.0);
+
+        // computes the next iterate; returns false without doing anything once the solve has finished
+        bool step();
+
+        bool done() const;
+        SolveStatus status() const;         // Running until done
+        const Eigen::VectorXd& iterate() const;
+        double errorNorm() const;
+        double stepNorm() const;
+        int getIterations() const;          // newton steps taken so far
+        int getEvaluations() const;         // forward kinematics evaluations, including rejected trial steps
+        int getJacobianEvaluations() const; // fresh jacobians; fewer than the iterations when the solver reuses them
+};
+
+#endif // NEWTONSTEPPER_H
@@ -0,0 +1,23 @@
+#ifndef PARALLELKINEMATICS_H
+#define PARALLELKINEMATICS_H
+
+#include <Eigen/Dense>
+#include "ThreadPool.h"
+
+// chains shorter than this run the serial kernels; below it the three pool round trips cost more than the trigonometry they split
+const int parallelKinematicsMinJoints = 16384;
+
+// forward kinematics and jacobian of a single long chain split across a thread pool as a parallel scan
+// the chain is cut into one block per worker: each block sums its joint angles, a serial exclusive scan over the few block
+// totals gives every block its starting angle, and each block then sums its own link vectors. The end effector is the sum of
+// the block sums; the jacobian additionally scans the block sums from the tip backwards so every block can turn its link
+// vectors into suffix sums on its own. Results match the serial kernels up to rounding in the order of the additions.
+// both functions block until done; the calling thread runs blocks itself, so they may be called from a task of the same pool
+// a null pool, a pool of one thread or a chain shorter than minJoints runs the serial kernel
+
+Eigen::Vector2d parallelEndEffector(const double* links, const double* jointAngles, int joints, ThreadPool* pool, int minJoints = parallelKinematicsMinJoints);
+
+// column-major 2 x joints, the same layout as IterativeSolver::jacobianKernel
+void parallelJacobianKernel(const double* links, const double* jointAngles, int joints, double* J, ThreadPool* pool, int minJoints = parallelKinematicsMinJoints);
+
+#endif // PARALLELKINEMATICS_H
@@ -0,0 +1,67 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// one completed span; name must be a string literal or otherwise outlive the profiler
+struct TraceEvent
+{
+    const char* name;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+};
+
+// this class collects timed spans into per thread buffers and exports them in the chrome trace event format
+// (loadable in chrome://tracing and ui.perfetto.dev); spans are only recorded when built with IK_ENABLE_PROFILING
+// each buffer is a ring of traceCapacity spans allocated when the thread registers; once it is full the oldest spans are
+// overwritten, so recording never allocates
+class Profiler
+{
+    public:
+        static constexpr std::size_t traceCapacity = 1 << 16; // spans kept per thread; a power of two
+
+        static std::int64_t now(); // steady clock in nanoseconds
+
+        // creates the calling thread's buffer; allocates on a thread's first call, so scopes call it as they open, and a span
+        // recorded inside a no-allocation region needs an enclosing scope opened before the region
+        static void registerThread();
+        static void record(const char* name, std::int64_t startNs, std::int64_t endNs); // writes into the calling thread's ring
+        static void clear();
+
+        // export every buffer; call once the recording threads are idle
+        static bool writeChromeTrace(const std::string& path);
+};
+
+// times the enclosing scope
+class ScopedTimer
+{
+    private:
+        const char* name;
+        std::int64_t start;
+    public:
+        explicit ScopedTimer(const char* spanName) : name(spanName), start(0)
+        {
+            Profiler::registerThread();
+            start = Profiler::now();
+        }
+        ~ScopedTimer() { Profiler::record(name, start, Profiler::now()); }
+};
+
+// disabled timers compile away entirely
+#define IK_PROFILE_CONCAT_INNER(a, b) a##b
+#define IK_PROFILE_CONCAT(a, b) IK_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef IK_ENABLE_PROFILING
+    #define IK_PROFILE_SCOPE(name) ScopedTimer IK_PROFILE_CONCAT(profileScope, __LINE__)(name)
+    #define IK_PROFILE_NOW() Profiler::now()
+    #define IK_PROFILE_SPAN(name, startNs, endNs) Profiler::record(name, startNs, endNs)
+#else
+    #define IK_PROFILE_SCOPE(name) ((void)0)
+    #define IK_PROFILE_NOW() std::int64_t(0)
+    #define IK_PROFILE_SPAN(name, startNs, endNs) ((void)0)
+#endif
+
+#endif // PROFILER_H
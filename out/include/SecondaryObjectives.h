@@ -0,0 +1,37 @@
+#ifndef SECONDARYOBJECTIVES_H
+#define SECONDARYOBJECTIVES_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+class ChainCollider;
+
+// objectives for the redundant joints of chains longer than two links, followed inside the null space of the jacobian
+// so they never disturb the end effector; a weight of zero switches an objective off and every weight is a gain per iteration
+struct SecondaryObjectives
+{
+    double jointLimitWeight = 0.0;     // pulls each joint towards the middle of [lowerLimits, upperLimits]
+    Eigen::VectorXd lowerLimits, upperLimits;
+
+    double restPoseWeight = 0.0;       // pulls the configuration towards restPose
+    Eigen::VectorXd restPose;
+
+    double manipulabilityWeight = 0.0; // climbs sqrt(det(J J^T)), moving away from singular configurations
+
+    double collisionWeight = 0.0;      // pushes links out of obstacles and each other; needs a collider
+    ChainCollider* collider = nullptr; // not owned; one per solver since detection writes its scratch buffers
+
+    bool active() const;
+};
+
+// writes the combined ascent direction of every active objective into z in O(n)
+// the joint limit and rest pose objectives are skipped unless their vectors have exactly joints entries
+// J is the column-major 2 x joints jacobian from IterativeSolver::jacobianKernel for the configuration q
+void secondaryObjectiveGradient(const SecondaryObjectives& objectives, const double* q, const double* J, int joints, double* z);
+
+// turns z into the full step: the minimum norm step for e plus z projected into the null space of J
+// step = z + J^T (J J^T)^-1 (e - J z), which is O(n) and never forms the joints x joints projector
+// z and step may be the same buffer
+void nullSpaceStep(const double* J, int joints, const Eigen::Vector2d& e, const double* z, double* step);
+
+#endif // SECONDARYOBJECTIVES_H
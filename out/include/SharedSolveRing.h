@@ -0,0 +1,160 @@
+#ifndef SHAREDSOLVERING_H
+#define SHAREDSOLVERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CompiledMechanism.h"
+#include "IterativeSolver.h"
+#include "SolverWorkspace.h"
+#include "ThreadPool.h"
+
+// shared memory transport between controller processes and a solver process on the same machine (linux)
+// a POSIX shm segment holds a header, the mechanism's link lengths and a ring of fixed-size slots. Each slot carries one
+// request and, once solved, its response: the client writes the target and the initial guess straight into the slot, the
+// solver reads them there and writes the solution back into the same slot, so nothing is serialized or copied through a
+// socket. Clients claim slots with a bounded multi-producer ring (one producer makes it spsc); each slot's 32-bit sequence
+// word moves from free (position) to requested (position + 1) to solved (position + 2) and back to free for the next lap
+// (position + slots) once the client has read the answer. Waiting sides spin for a while and then sleep on that word with a
+// futex, or spin forever when configured to busy-poll.
+// a client that claims a slot and never submits it stalls the ring behind it, the same as any ordered mpsc queue
+
+const std::uint32_t sharedRingMagic = 0x5248'4B49; // "IKHR"
+const std::uint32_t sharedRingVersion = 3;
+
+struct alignas(64) SharedRingHeader
+{
+    std::atomic<std::uint32_t> magic;           // stored last by the solver, once the ring is built
+    std::uint32_t version;
+    std::uint32_t slots;                        // power of two
+    std::uint32_t joints;
+    std::uint64_t slotBytes;                    // stride between slots
+    std::uint64_t segmentBytes;
+    std::uint64_t fingerprint;                  // CompiledMechanism::getFingerprint of the solver's mechanism
+    std::int32_t solverPid;                     // with solverRunning, tells a live ring from one left behind by a crashed solver
+    alignas(64) std::atomic<std::uint32_t> enqueuePosition;  // next ticket for producers
+    alignas(64) std::atomic<std::uint32_t> requestSignal;    // bumped on every submit; the sleeping solver waits on it
+    std::atomic<std::uint32_t> solverSleeping;
+    std::atomic<std::uint32_t> solverRunning;   // cleared when the solver stops, so waiting clients give up
+};
+
+struct alignas(64) SharedSlot
+{
+    std::atomic<std::uint32_t> sequence;
+    std::atomic<std::uint32_t> waiters;         // clients asleep on sequence
+
+    // request, written by the client before submitting
+    double targetX, targetY;
+    double tolerance;
+    double seconds;                             // time budget of the bounded solve
+    std::int32_t maxIterations;
+    std::uint32_t flags;                        // sharedSlotHasGuess
+
+    // response, written by the solver before marking the slot solved
+    std::int32_t status;                        // SolveStatus
+    std::int32_t iterations;
+    double error;
+    // followed by double guess[joints] and double solution[joints], each starting on a cache line
+};
+
+const std::uint32_t sharedSlotHasGuess = 1; // otherwise the solver seeds from optimizeInitialGuess
+
+// the ring's dimensions as one side last checked them; every attached process can write the header, so the solver keeps the
+// values it chose at start() and each client the ones it validated at attach(), and neither re-reads them from the segment
+struct SharedRingLayout
+{
+    std::uint32_t slots = 0;
+    std::uint32_t joints = 0;
+    std::size_t slotBytes = 0;
+    std::size_t segmentBytes = 0;
+};
+
+// how the waiting side of either end waits
+struct RingWait
+{
+    // polls before sleeping on a futex; negative polls forever. Spinning only pays when the other side has a core of its own
+    int spinIterations = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+};
+
+// this class owns the segment and runs the solver thread; it is the single consumer of the ring
+// ready slots are taken in ring order; runs of at least parallelBatch ready slots are split across the thread pool, shorter
+// ones are solved on the ring thread itself, which keeps a lone request free of any hand-off. Targets outside the mechanism's
+// workspace are answered at once with SolveStatus::Unreachable and the guess or seed as the solution
+class SharedRingServer
+{
+    private:
+        std::string name;
+        int descriptor;
+        SharedRingHeader* header;
+        SharedRingLayout layout;
+        CompiledMechanism mechanism;
+        IterativeSolver solver;
+        RingWait wait;
+        int parallelBatch;
+        std::unique_ptr<ThreadPool> pool;
+        std::vector<std::unique_ptr<SolverWorkspace>> workspaces; // one per pool chunk, plus one for the ring thread
+        std::atomic<bool> stopping;
+        std::thread thread;
+
+        void run();
+        void solveSlot(SharedSlot& slot, SolverWorkspace& workspace);
+        void waitForRequest(std::uint32_t position);
+
+    public:
+        // threads zero or one solves everything on the ring thread
+        SharedRingServer(const std::vector<double>& links, unsigned threads = 1, int parallelThreshold = 8, RingWait ringWait = RingWait());
+        ~SharedRingServer();
+
+        SharedRingServer(const SharedRingServer&) = delete;
+        SharedRingServer& operator=(const SharedRingServer&) = delete;
+
+        // creates /name (replacing a stale segment, refusing one a running solver serves) with slots rounded up to a power of two, at least four; false on failure
+        bool start(const std::string& segmentName, std::uint32_t slots = 64);
+        void stop(); // unlinks the name; attached clients keep their mapping but get no more answers
+};
+
+// a claimed slot; guess and solution point into the shared segment
+struct RingTicket
+{
+    std::uint32_t position = 0;
+    SharedSlot* slot = nullptr;
+    double* guess = nullptr;            // fill in before submit when passing a guess
+    const double* solution = nullptr;   // valid after a successful wait, until release
+};
+
+// this class attaches to a running SharedRingServer; safe to share between threads of one process, one ticket per thread
+// the zero-copy cycle is acquire, fill ticket.guess, submit, wait, read ticket.solution, release; solve() wraps it
+class SharedRingClient
+{
+    private:
+        SharedRingHeader* header;
+        SharedRingLayout layout;
+        RingWait wait;
+
+    public:
+        explicit SharedRingClient(RingWait ringWait = RingWait());
+        ~SharedRingClient();
+
+        SharedRingClient(const SharedRingClient&) = delete;
+        SharedRingClient& operator=(const SharedRingClient&) = delete;
+
+        bool attach(const std::string& segmentName);
+        void detach();
+        int getJoints() const;
+        std::uint64_t getFingerprint() const; // compare with CompiledMechanism::getFingerprint to check the solver's mechanism
+
+        bool acquire(RingTicket& ticket); // false when every slot is in use
+        void submit(RingTicket& ticket, Coord2D target, double tolerance, bool hasGuess, const SolveBudget& budget = SolveBudget());
+        bool waitFor(const RingTicket& ticket); // false if the solver stopped first; the slot is then lost for this run
+        void release(RingTicket& ticket);
+
+        // blocking round trip; copies the guess in and the solution out. A guess without exactly getJoints() entries is refused
+        // without a round trip, like a stopped solver, with BudgetExhausted and an infinite error
+        BoundedSolveResult solve(Coord2D target, double tolerance, const Eigen::VectorXd* guess, Eigen::VectorXd& solution, const SolveBudget& budget = SolveBudget());
+};
+
+#endif // SHAREDSOLVERING_H
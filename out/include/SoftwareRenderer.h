@@ -0,0 +1,36 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// this class draws the same scene as the GUI (dotted axes, mechanism, desired position) into an in-memory rgb image
+// no window or GL context is needed, so many renderers can run in parallel on display-less machines
+// drawing coordinates match the GUI's -1..1 orthographic view and use the same vertices as GUI::DrawMechanism
+class SoftwareRenderer
+{
+    private:
+        int width, height;
+        std::vector<std::uint8_t> pixels;  // rgb, row 0 at the top
+        std::vector<float> vertices;       // mechanism vertices reused between frames
+
+        void toPixel(float x, float y, float& px, float& py) const;
+        void setPixel(int px, int py, const std::uint8_t rgb[3]);
+        void fillSquare(float px, float py, float size, const std::uint8_t rgb[3]);             // matches glPointSize points
+        void drawThickLine(float x0, float y0, float x1, float y1, float lineWidth, const std::uint8_t rgb[3]); // pixel space
+
+    public:
+        SoftwareRenderer(int width, int height);
+
+        void clear(); // white background
+        void drawDottedAxis();
+        void drawMechanism(const std::vector<float>& linkLengths, const std::vector<float>& jointAngles);
+        void drawDesiredPosition(float x, float y); // mechanism units, like GUI::desiredPosition
+
+        const std::vector<std::uint8_t>& data() const;
+        bool writePPM(const std::string& path) const;
+        bool writePNG(const std::string& path) const; // uncompressed (stored) deflate, no external library
+};
+
+#endif // SOFTWARERENDERER_H
@@ -0,0 +1,58 @@
+#ifndef SOLVECLIENT_H
+#define SOLVECLIENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "IterativeSolver.h"
+#include "SolveProtocol.h"
+
+// answer to one solve, as sent back by the daemon
+struct RemoteSolveResult
+{
+    std::uint32_t requestId = 0;
+    SolveStatus status = SolveStatus::BudgetExhausted;
+    Eigen::VectorXd solution;
+    double error = 0;
+    int iterations = 0;
+    int batchSize = 0;          // solves the daemon ran together with this one
+    ServiceError failure = ServiceError::None; // set when the daemon refused the request; the other fields are then empty
+
+    bool converged() const { return failure == ServiceError::None && status == SolveStatus::Converged; }
+};
+
+// this class talks to an ik_daemon over its unix domain socket (posix only)
+// solve() is a blocking round trip; submitSolve() and receiveSolve() keep several solves in flight on one connection so
+// the daemon can batch them, and answers may come back in any order. Do not call loadMechanism() or stats() while solves
+// are outstanding. One client per thread.
+class SolveClient
+{
+    private:
+        int fd;
+        std::uint32_t nextRequest;
+        std::vector<char> payload; // receive buffer
+
+        bool receive(MessageHeader& header); // next message; its payload is left in payload
+
+    public:
+        SolveClient();
+        ~SolveClient();
+
+        SolveClient(const SolveClient&) = delete;
+        SolveClient& operator=(const SolveClient&) = delete;
+
+        bool connect(const std::string& socketPath);
+        void close();
+        bool connected() const;
+
+        std::uint32_t loadMechanism(const std::vector<double>& links); // daemon side id, zero on failure
+
+        // the guess is optional; without one the daemon seeds the solve from optimizeInitialGuess
+        bool solve(std::uint32_t mechanism, Coord2D target, double tolerance, RemoteSolveResult& result, const Eigen::VectorXd* guess = nullptr);
+        std::uint32_t submitSolve(std::uint32_t mechanism, Coord2D target, double tolerance, const Eigen::VectorXd* guess = nullptr); // request id, zero on failure
+        bool receiveSolve(RemoteSolveResult& result); // false once the connection is gone
+
+        bool stats(ServiceStats& current);
+};
+
+#endif // SOLVECLIENT_H
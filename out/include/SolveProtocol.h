@@ -0,0 +1,92 @@
+#ifndef SOLVEPROTOCOL_H
+#define SOLVEPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// wire format of the local solve service (ik_daemon, SolveClient)
+// every message is a MessageHeader followed by payloadBytes of payload. Fields are in host order and joint vectors are raw
+// float64 arrays: client and daemon always share a machine, so nothing is converted on either side.
+//
+//   LoadMechanism   payload float64 links[]                      -> MechanismLoaded, header.mechanism set
+//   Solve           payload SolveRequest [float64 guess[joints]] -> SolveReply, payload SolveReplyBody float64 solution[joints]
+//   Stats           no payload                                   -> StatsReply, payload ServiceStats
+//   any request that cannot be served                            -> Error, header.status holds a ServiceError
+//
+// replies carry the request id of the request they answer; solves may be answered out of order
+
+const std::uint32_t solveProtocolMagic = 0x5653'4B49; // "IKSV" in memory on little-endian machines
+const std::uint32_t maxPayloadBytes = 64u << 20;       // 8M joints per vector; larger frames drop the connection
+
+enum class MessageType : std::uint16_t
+{
+    LoadMechanism = 1,
+    MechanismLoaded,
+    Solve,
+    SolveReply,
+    Stats,
+    StatsReply,
+    Error
+};
+
+enum class ServiceError : std::uint16_t
+{
+    None = 0,
+    UnknownMechanism,
+    BadRequest,        // payload size does not match the message, or link lengths that are not finite and positive
+    UnknownMessage,
+    TooManyMechanisms  // the daemon already holds ServerConfig::maxMechanisms distinct mechanisms
+};
+
+struct MessageHeader
+{
+    std::uint32_t magic = solveProtocolMagic;
+    std::uint16_t type = 0;
+    std::uint16_t status = 0;       // ServiceError in Error replies
+    std::uint32_t requestId = 0;
+    std::uint32_t mechanism = 0;    // ids start at 1
+    std::uint32_t payloadBytes = 0;
+};
+
+const std::uint32_t solveHasGuess = 1; // SolveRequest::flags; otherwise the daemon seeds from optimizeInitialGuess
+
+struct SolveRequest
+{
+    double targetX = 0, targetY = 0;
+    double tolerance = 1e-6;
+    std::uint32_t flags = 0;
+    std::uint32_t joints = 0;       // guess length; must match the mechanism when solveHasGuess is set
+};
+
+struct SolveReplyBody
+{
+    std::int32_t status = 0;        // SolveStatus
+    std::int32_t iterations = 0;
+    double error = 0;
+    std::uint32_t batchSize = 0;    // solves coalesced into the batch this one ran in
+    std::uint32_t joints = 0;
+};
+
+// counters since the daemon started; latencies span receiving the request to sending the reply, over the most recent
+// solves only
+struct ServiceStats
+{
+    std::uint64_t requests = 0;
+    std::uint64_t batches = 0;
+    std::uint64_t failures = 0;     // solves that did not converge
+    std::uint32_t mechanisms = 0;
+    std::uint32_t connections = 0;
+    std::uint32_t queueDepth = 0;   // solves waiting right now
+    std::uint32_t maxQueueDepth = 0;
+    std::uint32_t maxBatch = 0;
+    std::uint32_t latencySamples = 0;
+    double meanBatch = 0;
+    double latencyP50 = 0, latencyP90 = 0, latencyP99 = 0, latencyMax = 0; // microseconds
+};
+
+// socket helpers shared by the daemon and the client; both return false once the peer is gone
+// sends the header, body and tail as one message; the header's payloadBytes must equal bodyBytes + tailBytes
+bool sendMessage(int fd, const MessageHeader& header, const void* body = nullptr, std::size_t bodyBytes = 0, const void* tail = nullptr, std::size_t tailBytes = 0);
+bool receiveExact(int fd, void* data, std::size_t bytes);
+
+#endif // SOLVEPROTOCOL_H
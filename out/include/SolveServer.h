@@ -0,0 +1,90 @@
+#ifndef SOLVESERVER_H
+#define SOLVESERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "CompiledMechanism.h"
+#include "IterativeSolver.h"
+#include "SolveProtocol.h"
+#include "ThreadPool.h"
+
+// daemon settings
+struct ServerConfig
+{
+    std::string socketPath = "/tmp/ik_solver.sock";
+    unsigned threads = 0;               // solver threads; zero means one per hardware thread
+    int maxBatch = 1024;                // solves taken from one mechanism's queue per batch
+    double coalesceMicroseconds = 0;    // extra wait after the first queued solve so more can join its batch
+    StepControl stepControl = StepControl::LineSearch;
+    JacobianReuse jacobianReuse;        // where each solve's jacobians come from
+    Termination termination;            // iteration cap and early exits of every solve
+    int maxMechanisms = 256;            // distinct link sets held at once; loading one more is refused
+    std::size_t maxReplyBacklog = 16u << 20; // reply bytes a client may leave unread before it is disconnected
+};
+
+// this class serves solve requests from other processes over a unix domain socket (posix only)
+// mechanisms are loaded once and shared: clients that load the same link lengths get the same id. One thread reads every
+// connection and queues solves per mechanism; a dispatcher thread takes whatever has queued up for a mechanism as one batch
+// and splits it across the thread pool, so concurrent requests coalesce by themselves whenever the solvers are busy. A target
+// outside the mechanism's workspace is answered with SolveStatus::Unreachable, zero iterations and the seed as the solution.
+// connections are non-blocking: a reply the socket cannot take at once waits in that connection's output queue, which the io
+// thread drains as the client reads, and a client that lets more than maxReplyBacklog bytes pile up is disconnected, so a
+// client that stops reading never holds up the solvers or anyone else
+class SolveServer
+{
+    private:
+        struct Connection;
+        struct PendingSolve;
+        struct Mechanism;
+
+        ServerConfig config;
+        ThreadPool pool;
+        int listenFd;
+        int wakePipe[2];                    // wakes the io thread on stop and when a reply has to wait for POLLOUT
+
+        mutable std::mutex mechanismMutex;
+        std::vector<std::unique_ptr<Mechanism>> mechanisms; // id - 1; never shrinks, so pointers stay valid
+        std::unordered_multimap<std::uint64_t, std::uint32_t> mechanismIds; // fingerprint to id; confirmed with sameLinks
+
+        mutable std::mutex queueMutex;
+        std::condition_variable queued;
+        int queueDepth;
+        bool stopping;
+
+        mutable std::mutex statsMutex;
+        ServiceStats counters;              // latency fields are filled in by stats()
+        std::vector<double> latencies;      // ring of the most recent solve latencies in microseconds
+        std::size_t latencyNext;
+        std::atomic<std::uint32_t> connectionCount;
+
+        std::thread ioThread;
+        std::thread dispatcherThread;
+
+        void ioLoop();
+        void dispatchLoop();
+        bool handleInput(const std::shared_ptr<Connection>& connection); // false when the connection should be dropped
+        void handleMessage(const std::shared_ptr<Connection>& connection, const MessageHeader& header, const char* payload);
+        std::uint32_t loadMechanism(const double* links, int count);
+        void solveBatch(Mechanism& mechanism, std::vector<PendingSolve>& batch);
+        void recordLatency(double microseconds);
+
+    public:
+        explicit SolveServer(const ServerConfig& serverConfig);
+        ~SolveServer();
+
+        SolveServer(const SolveServer&) = delete;
+        SolveServer& operator=(const SolveServer&) = delete;
+
+        bool start();   // binds the socket, replacing a stale one, and starts serving; prints the reason and returns false on failure
+        void stop();    // stops serving and removes the socket; queued solves are dropped
+        ServiceStats stats() const;
+};
+
+#endif // SOLVESERVER_H
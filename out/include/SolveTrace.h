@@ -0,0 +1,43 @@
+#ifndef SOLVETRACE_H
+#define SOLVETRACE_H
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+// per iteration record of a solve, kept only when the caller asks for it
+// joint angles live in one contiguous column-major joints x iterations buffer, so recording an iterate appends to a single
+// allocation instead of creating a vector per iteration, and the whole trace maps onto an Eigen matrix without copying
+class SolveTrace
+{
+    private:
+        int joints;
+        std::vector<double> angles;     // column i is iterate i
+        std::vector<double> errorNorms; // error norm at iterate i
+        std::vector<double> stepNorms;  // norm of the step that produced iterate i; zero for the initial guess
+
+    public:
+        SolveTrace();
+
+        void reset(int jointCount, int expectedIterations = 0);
+        void record(const Eigen::VectorXd& iterate, double errorNorm, double stepNorm);
+
+        bool empty() const;
+        int getJoints() const;
+        int getIterations() const;
+
+        Eigen::Map<const Eigen::MatrixXd> jointAngles() const; // joints x iterations
+        Eigen::Map<const Eigen::VectorXd> iterate(int iteration) const;
+        const std::vector<double>& getErrorNorms() const;
+        const std::vector<double>& getStepNorms() const;
+
+        // one row per iteration: iteration, error_norm, step_norm, q0 .. q(n-1)
+        bool writeCSV(const std::string& path) const;
+
+        // little-endian header "IKTRACE1", int32 joints, int32 iterations, then the column-major angles, the error norms and
+        // the step norms as float64
+        bool writeBinary(const std::string& path) const;
+        bool readBinary(const std::string& path);
+};
+
+#endif // SOLVETRACE_H
@@ -0,0 +1,50 @@
+#ifndef SOLVERWORKER_H
+#define SOLVERWORKER_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "IterativeSolver.h"
+#include "TripleBuffer.h"
+
+// joint state published by the solver thread for the render loop
+struct SolverState
+{
+    std::vector<float> jointAngles;
+    std::array<double, 2> target = { 0.0, 0.0 };
+    bool reachable = true;
+    bool converged = true;
+};
+
+// this class runs newton's method on its own thread and re-solves whenever the target moves
+// targets go in and joint states come out through triple buffers, so the render thread never blocks on the solver
+class SolverWorker
+{
+    private:
+        MechanismModel mechanism;
+        IterativeSolver solver;
+        Eigen::VectorXd current;                        // last converged configuration; warm start for the next target
+        bool reseed;                                    // the last solve failed, seed the next one from optimizeInitialGuess
+        TripleBuffer<std::array<double, 2>> targets;
+        TripleBuffer<SolverState> states;
+        std::atomic<unsigned> targetVersion;            // bumped for every new target and on shutdown
+        std::atomic<bool> stopping;
+        std::function<void()> onPublish;                // called on the worker thread after each published state
+        std::thread thread;
+
+        void run();
+
+    public:
+        SolverWorker(const std::vector<double>& linkLengths, const Eigen::VectorXd& initialAngles, std::function<void()> publishCallback = nullptr);
+        ~SolverWorker();
+
+        SolverWorker(const SolverWorker&) = delete;
+        SolverWorker& operator=(const SolverWorker&) = delete;
+
+        void setTarget(double x, double y); // render thread: request a solve for a new target; never blocks
+        bool poll();                        // render thread: picks up the newest solved state, returns whether it changed
+        const SolverState& latest() const;  // render thread: state picked up by the last poll()
+};
+
+#endif // SOLVERWORKER_H
@@ -0,0 +1,43 @@
+#ifndef SOLVERWORKSPACE_H
+#define SOLVERWORKSPACE_H
+
+#include <Eigen/Dense>
+#include <cstddef>
+
+// preallocated buffers for the deadline bounded solver, sized for one chain length
+// every buffer is written once on construction so its pages are already faulted in before the first real-time cycle,
+// and lockMemory() pins them so the kernel can never page them out in the middle of a cycle
+class SolverWorkspace
+{
+    private:
+        int joints;
+        bool locked;
+
+        void prefault();
+
+    public:
+        Eigen::MatrixXd J;          // 2 x joints jacobian
+        Eigen::VectorXd iterate;    // current newton iterate
+        Eigen::VectorXd best;       // iterate with the lowest error so far; the answer of a bounded solve
+        Eigen::VectorXd increment;  // newton step
+
+        explicit SolverWorkspace(int jointCount);
+        ~SolverWorkspace();
+        SolverWorkspace(const SolverWorkspace&) = delete;
+        SolverWorkspace& operator=(const SolverWorkspace&) = delete;
+
+        int getJoints() const;
+        void resize(int jointCount); // allocates; call outside the real-time loop
+
+        // pins the buffers in physical memory; false when the platform refuses (RLIMIT_MEMLOCK, missing privilege)
+        bool lockMemory();
+        void unlockMemory();
+        bool isLocked() const;
+
+        // process wide helpers for real-time threads: lock every current and future page, and touch stackBytes of stack
+        // so the first deep call in the control loop does not take a page fault
+        static bool lockAllMemory();
+        static void prefaultStack(std::size_t stackBytes = 64 * 1024);
+};
+
+#endif // SOLVERWORKSPACE_H
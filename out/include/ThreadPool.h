@@ -0,0 +1,45 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// this class defines a fixed set of worker threads that execute queued tasks
+// used by the tools that spread many independent solves across cores
+class ThreadPool
+{
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::pair<std::function<void()>, std::int64_t>> tasks; // task and the time it was queued
+        std::mutex mutex;
+        std::condition_variable taskAvailable;
+        std::condition_variable allDone;
+        int pending;   // tasks queued or running
+        bool stopping;
+
+        void workerLoop();
+
+    public:
+        // constructor; zero threads means one per hardware thread
+        explicit ThreadPool(unsigned threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned size() const;
+
+        void submit(std::function<void()> task); // queues a task for the next free worker
+        void wait();                              // blocks until every submitted task has finished; not from inside a task
+
+        // splits [begin, end) into chunks of at most grain indices and runs body(chunkBegin, chunkEnd) on the workers and the
+        // calling thread; returns once this loop's chunks are done, without waiting for other tasks. Safe to call from a task
+        void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body);
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,46 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// this class hands the latest value from one writer thread to one reader thread without locks or waiting
+// the writer fills its back slot and swaps it with the middle slot; the reader swaps the middle slot in only when it holds something new
+// slots are reused in place, so values that own memory (vectors) stop allocating once they reach their final size
+template <typename T>
+class TripleBuffer
+{
+    private:
+        static constexpr std::uint8_t indexMask = 0x3;
+        static constexpr std::uint8_t freshBit = 0x4; // set when the middle slot holds a value the reader has not seen
+
+        T slots[3];
+        std::atomic<std::uint8_t> middle;
+        std::uint8_t back;  // owned by the writer
+        std::uint8_t front; // owned by the reader
+
+    public:
+        TripleBuffer() : middle(1), back(0), front(2) {}
+
+        // writer side: fill the returned slot, then publish()
+        T& writeSlot() { return slots[back]; }
+
+        void publish()
+        {
+            back = middle.exchange(static_cast<std::uint8_t>(back | freshBit), std::memory_order_acq_rel) & indexMask;
+        }
+
+        // reader side: picks up the newest published value if there is one; returns whether it changed
+        bool update()
+        {
+            if (!(middle.load(std::memory_order_relaxed) & freshBit)) return false;
+
+            front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+            return true;
+        }
+
+        // reader side: the most recent value picked up by update()
+        const T& readSlot() const { return slots[front]; }
+};
+
+#endif // TRIPLEBUFFER_H
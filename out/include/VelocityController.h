@@ -0,0 +1,38 @@
+#ifndef VELOCITYCONTROLLER_H
+#define VELOCITYCONTROLLER_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+// this class maps a cartesian end effector velocity to joint velocities for servoing (differential inverse kinematics)
+// qdot = J^T (J J^T + damping^2 I)^-1 v is formed through the 2 x 2 matrix J J^T, so a cycle costs O(n) per pass
+// joint velocity and position limits are enforced by saturating the joint with the largest overshoot and re-solving the rest,
+// for at most maxSaturationPasses passes; all buffers are sized up front so a cycle never allocates
+class VelocityController
+{
+    private:
+        std::vector<double> links;
+        double dt;                   // control period, converts position limits into velocity bounds
+        double damping;              // zero gives the minimum norm solution
+        int maxSaturationPasses;
+
+        Eigen::VectorXd maxVelocity; // per joint, infinite when unset
+        Eigen::VectorXd lowerPosition, upperPosition;
+
+        Eigen::MatrixXd J;           // 2 x n work buffers
+        Eigen::VectorXd lower, upper;
+        std::vector<char> saturated;
+
+    public:
+        VelocityController(const std::vector<double>& linkLengths, double controlPeriod, double dampingFactor = 0.0, int saturationPasses = 8);
+
+        // limits need one entry per joint; false, keeping the previous limits, for any other size
+        bool setVelocityLimits(const Eigen::VectorXd& limits);
+        bool setPositionLimits(const Eigen::VectorXd& lowerLimits, const Eigen::VectorXd& upperLimits);
+
+        // writes joint velocities for the configuration q and cartesian velocity v into qdot; returns the number of saturated joints,
+        // or -1 without touching qdot when q or qdot does not have one entry per joint
+        int computeJointVelocities(const Eigen::Ref<const Eigen::VectorXd>& q, const Eigen::Vector2d& v, Eigen::Ref<Eigen::VectorXd> qdot);
+};
+
+#endif // VELOCITYCONTROLLER_H
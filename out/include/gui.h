@@ -13,22 +13,47 @@
 #include <chrono>
 #include <Eigen/Dense>
 #include <thread>
+#include <memory>
+#include "SolveTrace.h"
+
+class SolverWorker;
+
+// stages of a session; all of them live in the same window
+enum class SessionState {
+	Setup,    // editing the mechanism and target
+	Playback, // replaying the solver iterations
+	Live      // dragging the target while the solver thread follows
+};
 
 class GUI {
 	public:
 		GUI();
-		void RunGUI();
-		void VisualizeSolution(const std::vector<Eigen::VectorXd>& solution);
+		~GUI();
+		void Run();   // opens the window once and runs setup, solve and playback inside it until it is closed
+		bool Solve(); // solves for the current mechanism and target; false with a status message when there is no solution
 		void CheckOpenGLError(const std::string& label);
 		void DrawDottedAxis();
 		void DrawMechanism();
 		void DrawDesiredPosition();
+		void DrawSetupPanel(int screenWidth, int screenHeight);
+		void DrawSessionPanel();
 		int getJoints();
 		std::vector<float> getLinkLengths();
 		std::array<float, 2> getDesiredPosition();
 		int jointCount;
 		std::vector<float> linkLengths;
 		std::array<float, 2> desiredPosition = { 0 };
+		std::vector<float> jointAngles;       // angles currently drawn for each joint
+		SessionState state = SessionState::Setup;
+		std::string status;                   // result of the last solve, shown in the panels
+		SolveTrace solution;                  // iterations of the last solve, replayed in Playback
+		double replayStart = 0.0;
+		std::unique_ptr<SolverWorker> worker; // re-solves dragged targets for the current mechanism
+		std::vector<float> mechanismVertices; // joint positions of the current frame, reused between frames
+		float pixelSize = 0.0f;               // size of one pixel in drawing coordinates, drives the level of detail
+		void UpdatePixelSize(int screenWidth, int screenHeight);
+		bool DragTarget(GLFWwindow* window, int screenWidth, int screenHeight);
+		bool UpdateJointAngles(); // advances the replay or picks up solver results; returns whether the frame is animating
 };
 
 
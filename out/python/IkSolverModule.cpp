@@ -0,0 +1,419 @@
+// IkSolverModule.cpp : python extension module ik_solver; batch solves and forward kinematics over whole arrays.
+//                      Builds as the ik_solver target with IK_BUILD_PYTHON=ON; needs only the python headers.
+//
+// arrays cross the boundary through the buffer protocol, so numpy arrays (and anything else exporting C-contiguous float64
+// buffers) are read and written in place: targets and seeds are never copied, and results are written straight into either
+// the caller's out array or a fresh buffer handed back as a typed memoryview, which numpy.asarray wraps without a copy.
+// every call releases the GIL for the whole batch and splits it across a thread pool shared by all calls.
+//
+//   import numpy as np, ik_solver
+//   arm = ik_solver.Mechanism([1.0, 0.8, 0.5])
+//   solutions, status, iterations, errors = arm.solve(np.random.uniform(-1, 1, (100000, 2)))
+//   solutions = np.asarray(solutions)   # (100000, 3) view of the solver's output
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "../include/CompiledMechanism.h"
+#include "../include/InitialGuess.h"
+#include "../include/ParallelKinematics.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+
+static std::mutex poolMutex;
+static std::shared_ptr<ThreadPool> sharedPool; // created on first use, replaced when a call asks for a different thread count
+
+// returns the pool for a call; threads zero means one per hardware thread
+// batches run with the GIL released, so another thread may replace the shared pool while a batch is still using it: every
+// call keeps its own reference until the batch is done, and a replaced pool is destroyed only after its last batch finishes
+static std::shared_ptr<ThreadPool> poolFor(unsigned threads)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    const unsigned wanted = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    if (!sharedPool || sharedPool->size() != wanted) sharedPool = std::make_shared<ThreadPool>(wanted);
+    return sharedPool;
+}
+
+// owns a Py_buffer for the duration of a call
+struct BufferView
+{
+    Py_buffer view;
+    bool held = false;
+
+    ~BufferView()
+    {
+        if (held) PyBuffer_Release(&view);
+    }
+};
+
+// requests a C-contiguous float64 buffer of rows x columns, where a one dimensional buffer of length columns counts as a
+// single row when allowBroadcast is set; rows < 0 accepts any row count. Sets a python exception and returns false otherwise
+static bool getMatrix(PyObject* object, const char* name, bool writable, Py_ssize_t& rows, Py_ssize_t columns, bool allowBroadcast, BufferView& buffer)
+{
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(object, &buffer.view, flags) != 0) return false;
+    buffer.held = true;
+
+    const char* format = buffer.view.format ? buffer.view.format : "B";
+    const bool isDouble = buffer.view.itemsize == sizeof(double) && (std::strcmp(format, "d") == 0 || std::strcmp(format, "<d") == 0 || std::strcmp(format, "=d") == 0);
+    if (!isDouble)
+    {
+        PyErr_Format(PyExc_TypeError, "%s must hold float64 values", name);
+        return false;
+    }
+
+    const Py_ssize_t* shape = buffer.view.shape;
+    Py_ssize_t foundRows;
+    if (buffer.view.ndim == 2 && shape[1] == columns) foundRows = shape[0];
+    else if (allowBroadcast && buffer.view.ndim == 1 && shape[0] == columns) foundRows = 1;
+    else
+    {
+        PyErr_Format(PyExc_ValueError, "%s must have shape (N, %zd)", name, columns);
+        return false;
+    }
+
+    if (rows >= 0 && foundRows != rows && !(allowBroadcast && foundRows == 1))
+    {
+        PyErr_Format(PyExc_ValueError, "%s has %zd rows, expected %zd", name, foundRows, rows);
+        return false;
+    }
+    rows = foundRows;
+    return true;
+}
+
+// a fresh buffer handed back as a memoryview of the given shape and format; the memoryview owns the storage
+// memoryview.cast refuses shapes with a zero in them, so an empty result is described directly over a static byte instead
+static PyObject* newArray(Py_ssize_t rows, Py_ssize_t columns, const char* format, Py_ssize_t itemsize, char*& data)
+{
+    if (rows == 0)
+    {
+        static char nothing;
+        Py_ssize_t shape[2] = { 0, columns };
+        Py_ssize_t strides[2] = { columns * itemsize, itemsize };
+        Py_buffer view = {};
+        view.buf = data = &nothing;
+        view.itemsize = itemsize;
+        view.format = const_cast<char*>(format);
+        view.ndim = columns > 1 ? 2 : 1;
+        view.shape = shape;
+        view.strides = columns > 1 ? strides : strides + 1;
+        return PyMemoryView_FromBuffer(&view);
+    }
+
+    PyObject* storage = PyByteArray_FromStringAndSize(nullptr, rows * columns * itemsize);
+    if (!storage) return nullptr;
+    data = PyByteArray_AsString(storage);
+
+    PyObject* bytes = PyMemoryView_FromObject(storage);
+    Py_DECREF(storage);
+    if (!bytes) return nullptr;
+
+    PyObject* shape = columns > 1 ? Py_BuildValue("(nn)", rows, columns) : Py_BuildValue("(n)", rows);
+    PyObject* typed = shape ? PyObject_CallMethod(bytes, "cast", "sO", format, shape) : nullptr;
+    Py_XDECREF(shape);
+    Py_DECREF(bytes);
+    return typed;
+}
+
+// solves keep their own reference while the GIL is released, so re-running __init__ meanwhile cannot pull the mechanism
+// out from under them
+struct MechanismObject
+{
+    PyObject_HEAD
+    std::shared_ptr<const CompiledMechanism>* compiled;
+};
+
+static int Mechanism_init(MechanismObject* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = { "links", nullptr };
+    PyObject* linksObject;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", const_cast<char**>(keywords), &linksObject)) return -1;
+
+    PyObject* sequence = PySequence_Fast(linksObject, "links must be a sequence of lengths");
+    if (!sequence) return -1;
+
+    std::vector<double> links(PySequence_Fast_GET_SIZE(sequence));
+    for (std::size_t i = 0; i < links.size(); i++)
+    {
+        links[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(sequence, i));
+        if (PyErr_Occurred()) break;
+        if (!std::isfinite(links[i]) || links[i] <= 0.0) // the same links the daemon refuses
+        {
+            PyErr_SetString(PyExc_ValueError, "link lengths must be finite and positive");
+            break;
+        }
+    }
+    Py_DECREF(sequence);
+    if (PyErr_Occurred()) return -1;
+    if (links.empty())
+    {
+        PyErr_SetString(PyExc_ValueError, "a mechanism needs at least one link");
+        return -1;
+    }
+
+    auto compiled = CompiledMechanism::compile(links);
+    if (self->compiled) *self->compiled = std::move(compiled);
+    else self->compiled = new std::shared_ptr<const CompiledMechanism>(std::move(compiled));
+    return 0;
+}
+
+static void Mechanism_dealloc(MechanismObject* self)
+{
+    PyTypeObject* type = Py_TYPE(self);
+    delete self->compiled;
+    type->tp_free(reinterpret_cast<PyObject*>(self));
+    Py_DECREF(type);
+}
+
+// every method goes through here; false (with a python exception set) when __init__ never ran
+static bool isInitialized(MechanismObject* self)
+{
+    if (self->compiled) return true;
+    PyErr_SetString(PyExc_RuntimeError, "Mechanism.__init__ was not called");
+    return false;
+}
+
+static PyObject* Mechanism_joints(MechanismObject* self, void*)
+{
+    if (!isInitialized(self)) return nullptr;
+    return PyLong_FromLong((*self->compiled)->getJoints());
+}
+
+static PyObject* Mechanism_links(MechanismObject* self, void*)
+{
+    if (!isInitialized(self)) return nullptr;
+    const CompiledMechanism& compiled = **self->compiled;
+    PyObject* tuple = PyTuple_New(compiled.getJoints());
+    for (int i = 0; tuple && i < compiled.getJoints(); i++) PyTuple_SET_ITEM(tuple, i, PyFloat_FromDouble(compiled.getLinks()[i]));
+    return tuple;
+}
+
+static PyObject* Mechanism_reach(MechanismObject* self, void*)
+{
+    if (!isInitialized(self)) return nullptr;
+    return PyFloat_FromDouble((*self->compiled)->getReach());
+}
+
+static PyObject* Mechanism_fingerprint(MechanismObject* self, void*)
+{
+    if (!isInitialized(self)) return nullptr;
+    return PyLong_FromUnsignedLongLong((*self->compiled)->getFingerprint());
+}
+
+// solve(targets, seeds=None, out=None, tolerance=1e-6, threads=0, step_control="line-search", max_iterations=1000, jacobian="exact")
+static PyObject* Mechanism_solve(MechanismObject* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = { "targets", "seeds", "out", "tolerance", "threads", "step_control", "max_iterations", "jacobian", nullptr };
+    PyObject* targetsObject;
+    PyObject* seedsObject = Py_None;
+    PyObject* outObject = Py_None;
+    double tolerance = 1e-6;
+    unsigned threads = 0;
+    const char* stepControlName = "line-search";
+    Termination termination;
+    const char* jacobianName = "exact";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OOdIsis", const_cast<char**>(keywords), &targetsObject, &seedsObject, &outObject, &tolerance, &threads, &stepControlName, &termination.maxIterations, &jacobianName)) return nullptr;
+    if (termination.maxIterations < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "max_iterations must be positive");
+        return nullptr;
+    }
+
+    StepControl stepControl;
+    if (!parseStepControl(stepControlName, stepControl))
+    {
+        PyErr_SetString(PyExc_ValueError, "step_control must be 'full', 'line-search' or 'trust-region'");
+        return nullptr;
+    }
+
+    JacobianReuse jacobianReuse;
+    if (!parseJacobianUpdate(jacobianName, jacobianReuse.mode))
+    {
+        PyErr_SetString(PyExc_ValueError, "jacobian must be 'exact', 'broyden' or 'chord'");
+        return nullptr;
+    }
+
+    if (!isInitialized(self)) return nullptr;
+    const std::shared_ptr<const CompiledMechanism> compiled = *self->compiled;
+    const MechanismModel* m = &compiled->getModel();
+    const Py_ssize_t joints = compiled->getJoints();
+    Py_ssize_t count = -1, seedRows;
+    BufferView targets, seeds, out;
+    if (!getMatrix(targetsObject, "targets", false, count, 2, false, targets)) return nullptr;
+    seedRows = count;
+    if (seedsObject != Py_None && !getMatrix(seedsObject, "seeds", false, seedRows, joints, true, seeds)) return nullptr;
+
+    PyObject* solutions;
+    char* solutionData;
+    if (outObject != Py_None)
+    {
+        Py_ssize_t outRows = count;
+        if (!getMatrix(outObject, "out", true, outRows, joints, false, out)) return nullptr;
+        solutions = outObject;
+        Py_INCREF(solutions);
+        solutionData = static_cast<char*>(out.view.buf);
+    }
+    else if (!(solutions = newArray(count, joints, "d", sizeof(double), solutionData))) return nullptr;
+
+    char *statusData, *iterationData, *errorData;
+    PyObject* status = newArray(count, 1, "i", sizeof(int), statusData);
+    PyObject* iterations = status ? newArray(count, 1, "i", sizeof(int), iterationData) : nullptr;
+    PyObject* errors = iterations ? newArray(count, 1, "d", sizeof(double), errorData) : nullptr;
+    if (!errors)
+    {
+        Py_DECREF(solutions);
+        Py_XDECREF(status);
+        Py_XDECREF(iterations);
+        return nullptr;
+    }
+
+    const double* targetRows = static_cast<const double*>(targets.view.buf);
+    const double* seedData = seeds.held ? static_cast<const double*>(seeds.view.buf) : nullptr;
+    const bool broadcastSeed = seeds.held && seedRows == 1;
+    double* solutionRows = reinterpret_cast<double*>(solutionData);
+    int* statusOut = reinterpret_cast<int*>(statusData);
+    int* iterationsOut = reinterpret_cast<int*>(iterationData);
+    double* errorsOut = reinterpret_cast<double*>(errorData);
+
+    const std::shared_ptr<ThreadPool> poolReference = poolFor(threads);
+    ThreadPool& pool = *poolReference;
+    const int total = static_cast<int>(count);
+    const int grain = std::max(1, total / static_cast<int>(4 * pool.size())); // a few chunks per thread evens out slow solves
+
+    Py_BEGIN_ALLOW_THREADS
+    pool.parallelFor(0, total, grain, [&](int first, int last) {
+        IterativeSolver solver;
+        solver.setVerbose(false);
+        solver.setStepControl(stepControl);
+        solver.setJacobianReuse(jacobianReuse);
+        solver.setTermination(termination);
+
+        for (int i = first; i < last; i++)
+        {
+            Coord2D target(targetRows[2 * i], targetRows[2 * i + 1]);
+            Eigen::VectorXd seed = seedData ? Eigen::VectorXd(Eigen::Map<const Eigen::VectorXd>(seedData + (broadcastSeed ? 0 : i * joints), joints))
+                                            : optimizeInitialGuess(m, target);
+
+            SolveResult result;
+            if (compiled->isReachable(target)) result = solver.newtonSolve(m, seed, target, tolerance, 1e-6);
+            else
+            {
+                result.status = SolveStatus::Unreachable;
+                result.solution = std::move(seed);
+            }
+            std::copy(result.solution.data(), result.solution.data() + joints, solutionRows + static_cast<std::size_t>(i) * joints);
+            statusOut[i] = static_cast<int>(result.status);
+            iterationsOut[i] = result.iterations;
+            errorsOut[i] = result.error;
+        }
+    });
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue("(NNNN)", solutions, status, iterations, errors);
+}
+
+// end_effectors(angles, threads=0): (N, joints) joint angles to (N, 2) end effector positions
+static PyObject* Mechanism_end_effectors(MechanismObject* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = { "angles", "threads", nullptr };
+    PyObject* anglesObject;
+    unsigned threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|I", const_cast<char**>(keywords), &anglesObject, &threads)) return nullptr;
+
+    if (!isInitialized(self)) return nullptr;
+    const std::shared_ptr<const CompiledMechanism> compiled = *self->compiled;
+    const double* links = compiled->getLinks();
+    const int joints = compiled->getJoints();
+    Py_ssize_t count = -1;
+    BufferView angles;
+    if (!getMatrix(anglesObject, "angles", false, count, joints, false, angles)) return nullptr;
+
+    char* positionData;
+    PyObject* positions = newArray(count, 2, "d", sizeof(double), positionData);
+    if (!positions) return nullptr;
+
+    const double* angleRows = static_cast<const double*>(angles.view.buf);
+    double* positionRows = reinterpret_cast<double*>(positionData);
+    const std::shared_ptr<ThreadPool> poolReference = poolFor(threads);
+    ThreadPool& pool = *poolReference;
+    const int total = static_cast<int>(count);
+
+    Py_BEGIN_ALLOW_THREADS
+    pool.parallelFor(0, total, std::max(1, total / static_cast<int>(4 * pool.size())), [&](int first, int last) {
+        for (int i = first; i < last; i++)
+        {
+            Eigen::Vector2d position = parallelEndEffector(links, angleRows + static_cast<std::size_t>(i) * joints, joints, nullptr);
+            positionRows[2 * i] = position.x();
+            positionRows[2 * i + 1] = position.y();
+        }
+    });
+    Py_END_ALLOW_THREADS
+
+    return positions;
+}
+
+static PyGetSetDef Mechanism_getset[] = {
+    { "joints", reinterpret_cast<getter>(Mechanism_joints), nullptr, "number of joints", nullptr },
+    { "links", reinterpret_cast<getter>(Mechanism_links), nullptr, "link lengths", nullptr },
+    { "reach", reinterpret_cast<getter>(Mechanism_reach), nullptr, "length of the fully extended chain", nullptr },
+    { "fingerprint", reinterpret_cast<getter>(Mechanism_fingerprint), nullptr, "64-bit hash of the link lengths, the same in every process", nullptr },
+    { nullptr, nullptr, nullptr, nullptr, nullptr }
+};
+
+static PyMethodDef Mechanism_methods[] = {
+    { "solve", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Mechanism_solve)), METH_VARARGS | METH_KEYWORDS,
+      "solve(targets, seeds=None, out=None, tolerance=1e-6, threads=0, step_control='line-search', max_iterations=1000,\n"
+      "      jacobian='exact')\n"
+      "Solves every row of the (N, 2) float64 targets. seeds is (N, joints) or (joints,) for all rows; without it each solve is\n"
+      "seeded from the target's quadrant. Returns (solutions, status, iterations, errors); solutions is out when given, else a\n"
+      "new (N, joints) buffer. status holds the STATUS_* codes; targets outside the workspace are STATUS_UNREACHABLE, with the\n"
+      "seed as the solution." },
+    { "end_effectors", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(Mechanism_end_effectors)), METH_VARARGS | METH_KEYWORDS,
+      "end_effectors(angles, threads=0)\nEnd effector positions (N, 2) of the (N, joints) float64 joint angles." },
+    { nullptr, nullptr, 0, nullptr }
+};
+
+static PyType_Slot Mechanism_slots[] = {
+    { Py_tp_doc, const_cast<char*>("Mechanism(links)\nA planar serial chain with one revolute joint per link.") },
+    { Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew) },
+    { Py_tp_init, reinterpret_cast<void*>(Mechanism_init) },
+    { Py_tp_dealloc, reinterpret_cast<void*>(Mechanism_dealloc) },
+    { Py_tp_methods, Mechanism_methods },
+    { Py_tp_getset, Mechanism_getset },
+    { 0, nullptr }
+};
+
+static PyType_Spec Mechanism_spec = { "ik_solver.Mechanism", sizeof(MechanismObject), 0, Py_TPFLAGS_DEFAULT, Mechanism_slots };
+
+static PyModuleDef ikSolverModule = {
+    PyModuleDef_HEAD_INIT, "ik_solver", "Batch inverse kinematics for planar serial chains over buffer protocol arrays.", -1,
+    nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+PyMODINIT_FUNC PyInit_ik_solver()
+{
+    PyObject* module = PyModule_Create(&ikSolverModule);
+    if (!module) return nullptr;
+
+    PyObject* mechanismType = PyType_FromSpec(&Mechanism_spec);
+    if (!mechanismType || PyModule_AddObject(module, "Mechanism", mechanismType) < 0
+        || PyModule_AddIntConstant(module, "STATUS_CONVERGED", static_cast<int>(SolveStatus::Converged)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_BUDGET_EXHAUSTED", static_cast<int>(SolveStatus::BudgetExhausted)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_DIVERGING", static_cast<int>(SolveStatus::Diverging)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_STEP_TOO_SMALL", static_cast<int>(SolveStatus::StepTooSmall)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_STALLED", static_cast<int>(SolveStatus::Stalled)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_OSCILLATING", static_cast<int>(SolveStatus::Oscillating)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_NON_FINITE", static_cast<int>(SolveStatus::NonFinite)) < 0
+        || PyModule_AddIntConstant(module, "STATUS_UNREACHABLE", static_cast<int>(SolveStatus::Unreachable)) < 0)
+    {
+        Py_XDECREF(mechanismType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,72 @@
+// AllocationHooks.cpp : routes every heap allocation through AllocationTracker.
+//                       Linked only into targets that want allocation counts; see IK_TRACK_ALLOCATIONS in CMakeLists.txt.
+//                       On glibc the malloc family itself is replaced, so Eigen's aligned_malloc (which bypasses operator new)
+//                       is counted too; elsewhere only the global operator new and delete are replaced.
+
+#include "../include/AllocationTracker.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+
+extern "C"
+{
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void* p, std::size_t size);
+    void __libc_free(void* p);
+
+    void* malloc(std::size_t size) noexcept
+    {
+        AllocationTracker::recordAllocation(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) noexcept
+    {
+        AllocationTracker::recordAllocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* p, std::size_t size) noexcept
+    {
+        AllocationTracker::recordAllocation(size);
+        return __libc_realloc(p, size);
+    }
+
+    void free(void* p) noexcept
+    {
+        __libc_free(p);
+    }
+}
+
+#else
+
+static void* trackedAllocate(std::size_t size)
+{
+    AllocationTracker::recordAllocation(size);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return trackedAllocate(size); }
+void* operator new[](std::size_t size) { return trackedAllocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    AllocationTracker::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#endif
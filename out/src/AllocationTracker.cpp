@@ -0,0 +1,119 @@
+#include "../include/AllocationTracker.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+static const int phaseCount = static_cast<int>(AllocationPhase::Count);
+
+// process wide counters
+static std::atomic<long long> allocationCounts[phaseCount];
+static std::atomic<long long> allocationBytes[phaseCount];
+static std::atomic<long long> violationCount{ 0 };
+static std::atomic<bool> abortOnViolation{ true };
+
+// per thread state; plain types so operator new can touch them safely
+static thread_local AllocationPhase threadPhase = AllocationPhase::Other;
+static thread_local int noAllocationDepth = 0;
+static thread_local const char* noAllocationName = nullptr;
+
+long long AllocationSnapshot::totalAllocations() const
+{
+    long long total = 0;
+    for (long long a : allocations) total += a;
+    return total;
+}
+
+long long AllocationSnapshot::totalBytes() const
+{
+    long long total = 0;
+    for (long long b : bytes) total += b;
+    return total;
+}
+
+// count an allocation against the current phase and check the no-allocation regions
+void AllocationTracker::recordAllocation(std::size_t size)
+{
+    int phase = static_cast<int>(threadPhase);
+    allocationCounts[phase].fetch_add(1, std::memory_order_relaxed);
+    allocationBytes[phase].fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+
+    if (noAllocationDepth > 0)
+    {
+        violationCount.fetch_add(1, std::memory_order_relaxed);
+        if (abortOnViolation.load(std::memory_order_relaxed))
+        {
+            noAllocationDepth = 0; // the report below may allocate itself
+            std::fprintf(stderr, "Allocation of %zu bytes inside no-allocation region '%s'.\n", size, noAllocationName);
+            std::abort();
+        }
+    }
+}
+
+AllocationSnapshot AllocationTracker::snapshot()
+{
+    AllocationSnapshot s;
+    for (int i = 0; i < phaseCount; i++)
+    {
+        s.allocations[i] = allocationCounts[i].load(std::memory_order_relaxed);
+        s.bytes[i] = allocationBytes[i].load(std::memory_order_relaxed);
+    }
+    s.violations = violationCount.load(std::memory_order_relaxed);
+    return s;
+}
+
+void AllocationTracker::reset()
+{
+    for (int i = 0; i < phaseCount; i++)
+    {
+        allocationCounts[i].store(0, std::memory_order_relaxed);
+        allocationBytes[i].store(0, std::memory_order_relaxed);
+    }
+    violationCount.store(0, std::memory_order_relaxed);
+}
+
+// print one line per phase
+void AllocationTracker::report(std::ostream& out, const AllocationSnapshot& s)
+{
+    for (int i = 0; i < phaseCount; i++)
+    {
+        out << phaseName(static_cast<AllocationPhase>(i)) << ": " << s.allocations[i] << " allocations, " << s.bytes[i] << " bytes\n";
+    }
+    out << "no-allocation violations: " << s.violations << "\n";
+}
+
+const char* AllocationTracker::phaseName(AllocationPhase phase)
+{
+    switch (phase)
+    {
+        case AllocationPhase::ForwardKinematics: return "forward kinematics";
+        case AllocationPhase::Jacobian: return "jacobian";
+        case AllocationPhase::LinearSolve: return "linear solve";
+        case AllocationPhase::History: return "history";
+        default: return "other";
+    }
+}
+
+void AllocationTracker::setAbortOnViolation(bool enabled)
+{
+    abortOnViolation.store(enabled);
+}
+
+AllocationPhase AllocationTracker::currentPhase()
+{
+    return threadPhase;
+}
+
+void AllocationTracker::setCurrentPhase(AllocationPhase phase)
+{
+    threadPhase = phase;
+}
+
+void AllocationTracker::enterNoAllocationRegion(const char* name)
+{
+    if (noAllocationDepth++ == 0) noAllocationName = name;
+}
+
+void AllocationTracker::leaveNoAllocationRegion()
+{
+    noAllocationDepth--;
+}
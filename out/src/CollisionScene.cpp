@@ -0,0 +1,419 @@
+#include "../include/CollisionScene.h"
+#include "../include/AllocationTracker.h"
+#include "../include/FastTrig.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 2d cross product; positive when b is counter-clockwise from a
+static double cross(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+    return a.x() * b.y() - a.y() * b.x();
+}
+
+static Eigen::Vector2d closestPointOnSegment(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& p)
+{
+    const Eigen::Vector2d ab = b - a;
+    const double lengthSquared = ab.squaredNorm();
+    const double t = lengthSquared > 0.0 ? std::clamp((p - a).dot(ab) / lengthSquared, 0.0, 1.0) : 0.0;
+    return a + t * ab;
+}
+
+// closest points between segments ab and cd, written to p (on ab) and q (on cd); returns the squared distance
+static double closestPointsBetweenSegments(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c, const Eigen::Vector2d& d, Eigen::Vector2d& p, Eigen::Vector2d& q)
+{
+    const Eigen::Vector2d u = b - a, v = d - c;
+
+    // crossing segments touch at their intersection
+    const double denominator = cross(u, v);
+    if (denominator != 0.0)
+    {
+        const double s = cross(c - a, v) / denominator, t = cross(c - a, u) / denominator;
+        if (s >= 0.0 && s <= 1.0 && t >= 0.0 && t <= 1.0)
+        {
+            p = a + s * u;
+            q = p;
+            return 0.0;
+        }
+    }
+
+    // otherwise the closest pair involves an endpoint of one of the segments
+    double best = std::numeric_limits<double>::infinity();
+    auto consider = [&](const Eigen::Vector2d& onAb, const Eigen::Vector2d& onCd) {
+        const double distance = (onAb - onCd).squaredNorm();
+        if (distance < best)
+        {
+            best = distance;
+            p = onAb;
+            q = onCd;
+        }
+    };
+    consider(a, closestPointOnSegment(c, d, a));
+    consider(b, closestPointOnSegment(c, d, b));
+    consider(closestPointOnSegment(a, b, c), c);
+    consider(closestPointOnSegment(a, b, d), d);
+    return best;
+}
+
+// unit vector perpendicular to ab, used when a contact normal is degenerate
+static Eigen::Vector2d perpendicular(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+    const Eigen::Vector2d ab = b - a;
+    const double length = ab.norm();
+    return length > 0.0 ? Eigen::Vector2d(-ab.y() / length, ab.x() / length) : Eigen::Vector2d(1.0, 0.0);
+}
+
+// constructor
+CollisionScene::CollisionScene() : cellSize(1.0), built(false) {}
+
+int CollisionScene::addCircle(const Eigen::Vector2d& center, double radius)
+{
+    Obstacle obstacle;
+    obstacle.shape = Obstacle::Shape::Circle;
+    obstacle.center = center;
+    obstacle.radius = radius;
+    obstacle.bounds = { center - Eigen::Vector2d::Constant(radius), center + Eigen::Vector2d::Constant(radius) };
+
+    obstacles.push_back(obstacle);
+    built = false;
+    return static_cast<int>(obstacles.size()) - 1;
+}
+
+int CollisionScene::addBox(const Eigen::Vector2d& min, const Eigen::Vector2d& max)
+{
+    return addPolygon({ min, Eigen::Vector2d(max.x(), min.y()), max, Eigen::Vector2d(min.x(), max.y()) });
+}
+
+int CollisionScene::addPolygon(const std::vector<Eigen::Vector2d>& vertices)
+{
+    Obstacle obstacle;
+    obstacle.shape = Obstacle::Shape::Polygon;
+    obstacle.vertices = vertices;
+
+    // signed area and area centroid; clockwise input is reversed so every polygon is counter-clockwise
+    double area = 0.0;
+    Eigen::Vector2d centroid = Eigen::Vector2d::Zero();
+    const int count = static_cast<int>(vertices.size());
+    for (int i = 0; i < count; i++)
+    {
+        const Eigen::Vector2d& a = vertices[i];
+        const Eigen::Vector2d& b = vertices[(i + 1) % count];
+        const double twiceTriangle = cross(a, b);
+        area += twiceTriangle / 2;
+        centroid += (a + b) * twiceTriangle / 6;
+    }
+    if (area < 0.0) std::reverse(obstacle.vertices.begin(), obstacle.vertices.end());
+
+    obstacle.center = std::abs(area) > 0.0 ? Eigen::Vector2d(centroid / area) : Eigen::Vector2d(vertices.empty() ? Eigen::Vector2d::Zero() : vertices[0]);
+    obstacle.bounds = { obstacle.center, obstacle.center };
+    for (const Eigen::Vector2d& v : vertices)
+    {
+        obstacle.bounds.min = obstacle.bounds.min.cwiseMin(v);
+        obstacle.bounds.max = obstacle.bounds.max.cwiseMax(v);
+    }
+
+    obstacles.push_back(obstacle);
+    built = false;
+    return static_cast<int>(obstacles.size()) - 1;
+}
+
+long long CollisionScene::cellCoordinate(double value) const
+{
+    return static_cast<long long>(std::floor(value / cellSize));
+}
+
+std::size_t CollisionScene::bucketOf(long long cellX, long long cellY) const
+{
+    // large odd multipliers spread neighbouring cells over the table; the table size is a power of two
+    const unsigned long long hash = static_cast<unsigned long long>(cellX) * 73856093ULL ^ static_cast<unsigned long long>(cellY) * 19349663ULL;
+    return static_cast<std::size_t>(hash & (bucketStart.size() - 2));
+}
+
+void CollisionScene::build(double gridCellSize)
+{
+    if (gridCellSize <= 0.0) // mean extent keeps most obstacles in a handful of cells
+    {
+        double extent = 0.0;
+        for (const Obstacle& o : obstacles) extent += (o.bounds.max - o.bounds.min).maxCoeff();
+        gridCellSize = obstacles.empty() ? 1.0 : extent / obstacles.size();
+    }
+    cellSize = std::max(gridCellSize, 1e-9);
+
+    // first pass counts the cell entries to size the table, second pass counts per bucket, third fills
+    std::size_t entryCount = 0;
+    for (const Obstacle& o : obstacles)
+    {
+        entryCount += static_cast<std::size_t>(cellCoordinate(o.bounds.max.x()) - cellCoordinate(o.bounds.min.x()) + 1)
+            * static_cast<std::size_t>(cellCoordinate(o.bounds.max.y()) - cellCoordinate(o.bounds.min.y()) + 1);
+    }
+
+    std::size_t bucketCount = 16;
+    while (bucketCount < 2 * entryCount) bucketCount *= 2;
+    bucketStart.assign(bucketCount + 1, 0);
+
+    auto forEachCell = [&](const Obstacle& o, auto body) {
+        for (long long cx = cellCoordinate(o.bounds.min.x()); cx <= cellCoordinate(o.bounds.max.x()); cx++)
+        {
+            for (long long cy = cellCoordinate(o.bounds.min.y()); cy <= cellCoordinate(o.bounds.max.y()); cy++) body(bucketOf(cx, cy));
+        }
+    };
+
+    for (const Obstacle& o : obstacles) forEachCell(o, [&](std::size_t bucket) { bucketStart[bucket + 1]++; });
+    for (std::size_t b = 0; b < bucketCount; b++) bucketStart[b + 1] += bucketStart[b];
+
+    entries.assign(entryCount, 0);
+    std::vector<int> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (int i = 0; i < static_cast<int>(obstacles.size()); i++) forEachCell(obstacles[i], [&](std::size_t bucket) { entries[fill[bucket]++] = i; });
+
+    built = true;
+}
+
+int CollisionScene::getObstacleCount() const
+{
+    return static_cast<int>(obstacles.size());
+}
+
+const Obstacle& CollisionScene::getObstacle(int index) const
+{
+    return obstacles[index];
+}
+
+bool CollisionScene::isBuilt() const
+{
+    return built;
+}
+
+// constructor; sizes every scratch buffer for the chain
+ChainCollider::ChainCollider(const CollisionScene* collisionScene, int linkCount, double capsuleRadius, bool checkSelfCollision)
+    : scene(collisionScene), linkRadius(capsuleRadius), selfCollision(checkSelfCollision), stamp(0)
+{
+    resize(linkCount);
+    stamps.assign(scene ? scene->getObstacleCount() : 0, 0);
+}
+
+void ChainCollider::resize(int linkCount)
+{
+    if (static_cast<int>(linkBounds.size()) == linkCount) return;
+
+    joints.resize(linkCount + 1);
+    linkBounds.resize(linkCount);
+    linkLoads.resize(linkCount);
+    sweepOrder.resize(linkCount);
+    for (int i = 0; i < linkCount; i++) sweepOrder[i] = i;
+    contacts.reserve(4 * static_cast<std::size_t>(linkCount) + 16);
+}
+
+int ChainCollider::detect(const double* J, int linkCount)
+{
+    resize(linkCount);
+
+    // column k of J is the vector from joint k to the end effector rotated by 90 degrees, and column 0 reaches from the base
+    const Eigen::Vector2d tip(J[1], -J[0]);
+    for (int k = 0; k < linkCount; k++) joints[k] = tip - Eigen::Vector2d(J[2 * k + 1], -J[2 * k]);
+    joints[linkCount] = tip;
+
+    return detectContacts(linkCount);
+}
+
+int ChainCollider::detect(const std::vector<double>& links, const Eigen::VectorXd& jointAngles)
+{
+    const int linkCount = static_cast<int>(links.size());
+    resize(linkCount);
+
+    joints[0] = Eigen::Vector2d::Zero();
+    cumulativeSinCos(0.0, jointAngles.data(), 0, linkCount, [&](int k, double c, double s) {
+        joints[k + 1] = joints[k] + links[k] * Eigen::Vector2d(c, s);
+    });
+
+    return detectContacts(linkCount);
+}
+
+int ChainCollider::detectContacts(int linkCount)
+{
+    if (scene && static_cast<int>(stamps.size()) != scene->getObstacleCount()) stamps.assign(scene->getObstacleCount(), 0); // obstacles added after construction
+
+    IK_NO_ALLOCATION_REGION("collision detection");
+    contacts.clear();
+
+    const Eigen::Vector2d margin = Eigen::Vector2d::Constant(linkRadius);
+    for (int k = 0; k < linkCount; k++)
+    {
+        linkBounds[k] = { joints[k].cwiseMin(joints[k + 1]) - margin, joints[k].cwiseMax(joints[k + 1]) + margin };
+    }
+
+    if (scene && scene->getObstacleCount() > 0) detectObstacles(linkCount);
+    if (selfCollision) detectSelfCollisions(linkCount);
+
+    return static_cast<int>(contacts.size());
+}
+
+// broad phase through the scene's spatial hash, then the exact capsule test against each candidate
+void ChainCollider::detectObstacles(int linkCount)
+{
+    for (int k = 0; k < linkCount; k++)
+    {
+        const Eigen::Vector2d& a = joints[k];
+        const Eigen::Vector2d& b = joints[k + 1];
+
+        if (++stamp == 0) // wrapped around: old stamps could alias the new one
+        {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            stamp = 1;
+        }
+
+        scene->query(linkBounds[k], stamps, stamp, [&](int index) {
+            const Obstacle& o = scene->getObstacle(index);
+            Contact contact;
+            contact.link = k;
+            contact.other = index;
+
+            if (o.shape == Obstacle::Shape::Circle)
+            {
+                contact.point = closestPointOnSegment(a, b, o.center);
+                const double distance = (contact.point - o.center).norm();
+                contact.depth = o.radius + linkRadius - distance;
+                contact.normal = distance > 0.0 ? Eigen::Vector2d((contact.point - o.center) / distance) : perpendicular(a, b);
+            }
+            else
+            {
+                // nearest pair between the link and the polygon's edges; the link is inside when it crosses an edge or
+                // when its first point lies left of every counter-clockwise edge
+                const int count = static_cast<int>(o.vertices.size());
+                double nearest = std::numeric_limits<double>::infinity();
+                bool inside = count > 2;
+                Eigen::Vector2d onLink = a, onPolygon = a;
+                for (int i = 0; i < count; i++)
+                {
+                    const Eigen::Vector2d& c = o.vertices[i];
+                    const Eigen::Vector2d& d = o.vertices[(i + 1) % count];
+                    Eigen::Vector2d p, q;
+                    const double distance = closestPointsBetweenSegments(a, b, c, d, p, q);
+                    if (distance < nearest)
+                    {
+                        nearest = distance;
+                        onLink = p;
+                        onPolygon = q;
+                    }
+                    if (cross(d - c, a - c) < 0.0) inside = false;
+                }
+                nearest = std::sqrt(nearest);
+
+                if (inside || nearest == 0.0)
+                {
+                    // penetrating: push the link point nearest the centroid out through the closest edge
+                    contact.point = closestPointOnSegment(a, b, o.center);
+                    double toBoundary = std::numeric_limits<double>::infinity();
+                    for (int i = 0; i < count; i++)
+                    {
+                        const Eigen::Vector2d onEdge = closestPointOnSegment(o.vertices[i], o.vertices[(i + 1) % count], contact.point);
+                        toBoundary = std::min(toBoundary, (contact.point - onEdge).norm());
+                    }
+                    const Eigen::Vector2d away = contact.point - o.center;
+                    contact.depth = linkRadius + toBoundary;
+                    contact.normal = away.norm() > 0.0 ? Eigen::Vector2d(away.normalized()) : perpendicular(a, b);
+                }
+                else
+                {
+                    contact.point = onLink;
+                    contact.depth = linkRadius - nearest;
+                    contact.normal = (onLink - onPolygon) / nearest;
+                }
+            }
+
+            if (contact.depth > 0.0) addContact(contact);
+        });
+    }
+}
+
+// sweep and prune over the link boxes on the x axis
+void ChainCollider::detectSelfCollisions(int linkCount)
+{
+    // insertion sort: the order from the previous call is nearly right after one newton step
+    for (int i = 1; i < linkCount; i++)
+    {
+        const int link = sweepOrder[i];
+        const double key = linkBounds[link].min.x();
+        int j = i - 1;
+        for (; j >= 0 && linkBounds[sweepOrder[j]].min.x() > key; j--) sweepOrder[j + 1] = sweepOrder[j];
+        sweepOrder[j + 1] = link;
+    }
+
+    for (int i = 0; i < linkCount; i++)
+    {
+        const int first = sweepOrder[i];
+        for (int j = i + 1; j < linkCount && linkBounds[sweepOrder[j]].min.x() <= linkBounds[first].max.x(); j++)
+        {
+            const int second = sweepOrder[j];
+            if (std::abs(first - second) <= 1 || !linkBounds[first].overlaps(linkBounds[second])) continue; // neighbours share a joint
+
+            Eigen::Vector2d p, q;
+            const double distance = std::sqrt(closestPointsBetweenSegments(joints[first], joints[first + 1], joints[second], joints[second + 1], p, q));
+            const double depth = 2 * linkRadius - distance;
+            if (depth <= 0.0) continue;
+
+            const Eigen::Vector2d normal = distance > 0.0 ? Eigen::Vector2d((p - q) / distance) : perpendicular(joints[second], joints[second + 1]);
+
+            Contact contact;
+            contact.selfCollision = true;
+            contact.depth = depth;
+
+            contact.link = first;
+            contact.other = second;
+            contact.point = p;
+            contact.normal = normal;
+            addContact(contact);
+
+            contact.link = second;
+            contact.other = first;
+            contact.point = q;
+            contact.normal = -normal;
+            addContact(contact);
+        }
+    }
+}
+
+// keeps contacts inside the capacity reserved by resize(), so detection never allocates inside a solve; once it is full a new
+// contact only goes in by replacing the shallowest one, if it is deeper
+void ChainCollider::addContact(const Contact& contact)
+{
+    if (contacts.size() < contacts.capacity())
+    {
+        contacts.push_back(contact);
+        return;
+    }
+
+    auto shallowest = std::min_element(contacts.begin(), contacts.end(), [](const Contact& x, const Contact& y) { return x.depth < y.depth; });
+    if (shallowest != contacts.end() && shallowest->depth < contact.depth) *shallowest = contact;
+}
+
+const std::vector<Contact>& ChainCollider::getContacts() const
+{
+    return contacts;
+}
+
+double ChainCollider::totalPenetration() const
+{
+    double total = 0.0;
+    for (const Contact& c : contacts) total += c.depth;
+    return total;
+}
+
+void ChainCollider::addPenaltyGradient(double weight, double* z)
+{
+    const int linkCount = static_cast<int>(linkLoads.size());
+    for (Eigen::Vector3d& load : linkLoads) load.setZero();
+
+    // a push f at point p moves joint k by cross(p - joint k, f); summing per link first keeps this O(n + contacts)
+    for (const Contact& c : contacts)
+    {
+        const Eigen::Vector2d force = weight * c.depth * c.normal;
+        linkLoads[c.link] += Eigen::Vector3d(force.x(), force.y(), cross(c.point, force));
+    }
+
+    Eigen::Vector3d suffix = Eigen::Vector3d::Zero(); // loads on links k and beyond, which joint k moves
+    for (int k = linkCount - 1; k >= 0; k--)
+    {
+        suffix += linkLoads[k];
+        z[k] += suffix.z() - cross(joints[k], Eigen::Vector2d(suffix.x(), suffix.y()));
+    }
+}
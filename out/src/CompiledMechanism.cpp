@@ -0,0 +1,130 @@
+#include "../include/CompiledMechanism.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+
+// doubles per array, rounded up so every array starts on its own cache line
+static std::size_t paddedLength(int joints)
+{
+    const std::size_t perLine = cacheLineBytes / sizeof(double);
+    return (static_cast<std::size_t>(std::max(joints, 1)) + perLine - 1) / perLine * perLine;
+}
+
+void CompiledMechanism::AlignedDelete::operator()(double* data) const
+{
+    ::operator delete[](data, std::align_val_t(cacheLineBytes));
+}
+
+// constructor; every derived quantity is computed here and never touched again
+CompiledMechanism::CompiledMechanism(const std::vector<double>& links)
+    : joints(static_cast<int>(links.size())), reach(0.0), innerReach(0.0), fingerprint(0), model(links)
+{
+    const std::size_t stride = paddedLength(joints);
+    double* data = static_cast<double*>(::operator new[](3 * stride * sizeof(double), std::align_val_t(cacheLineBytes)));
+    std::fill(data, data + 3 * stride, 0.0);
+    storage.reset(data);
+
+    double* lengthArray = data;
+    double* cumulativeArray = data + stride;
+    double* remainingArray = data + 2 * stride;
+
+    double longest = 0.0;
+    for (int i = 0; i < joints; i++)
+    {
+        lengthArray[i] = links[i];
+        reach += links[i];
+        cumulativeArray[i] = reach;
+        longest = std::max(longest, links[i]);
+    }
+    for (int i = 0; i < joints; i++) remainingArray[i] = reach - (i ? cumulativeArray[i - 1] : 0.0);
+
+    // the chain cannot bring its tip closer to the base than the longest link minus everything else
+    innerReach = std::max(0.0, 2.0 * longest - reach);
+
+    lengths = lengthArray;
+    cumulativeLengths = cumulativeArray;
+    remainingReach = remainingArray;
+
+    const std::uint64_t prime = 0x100000001b3ull;
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&](std::uint64_t word) {
+        for (int byte = 0; byte < 8; byte++)
+        {
+            hash ^= (word >> (8 * byte)) & 0xff;
+            hash *= prime;
+        }
+    };
+    mix(static_cast<std::uint64_t>(joints));
+    for (int i = 0; i < joints; i++)
+    {
+        const double length = links[i] == 0.0 ? 0.0 : links[i]; // -0 and +0 are the same link
+        std::uint64_t bits;
+        std::memcpy(&bits, &length, sizeof(bits));
+        mix(bits);
+    }
+    fingerprint = hash;
+}
+
+CompiledMechanism::CompiledMechanism(const MechanismModel& mechanism) : CompiledMechanism(mechanism.getLinks()) {}
+
+std::shared_ptr<const CompiledMechanism> CompiledMechanism::compile(const std::vector<double>& links)
+{
+    return std::make_shared<const CompiledMechanism>(links);
+}
+
+int CompiledMechanism::getJoints() const
+{
+    return joints;
+}
+
+const double* CompiledMechanism::getLinks() const
+{
+    return lengths;
+}
+
+const double* CompiledMechanism::getCumulativeLengths() const
+{
+    return cumulativeLengths;
+}
+
+const double* CompiledMechanism::getRemainingReach() const
+{
+    return remainingReach;
+}
+
+double CompiledMechanism::getReach() const
+{
+    return reach;
+}
+
+double CompiledMechanism::getInnerReach() const
+{
+    return innerReach;
+}
+
+const MechanismModel& CompiledMechanism::getModel() const
+{
+    return model;
+}
+
+std::uint64_t CompiledMechanism::getFingerprint() const
+{
+    return fingerprint;
+}
+
+bool CompiledMechanism::sameLinks(const CompiledMechanism& other) const
+{
+    return joints == other.joints && std::equal(lengths, lengths + joints, other.lengths);
+}
+
+bool CompiledMechanism::isOutOfReach(const Coord2D& point) const
+{
+    return std::hypot(point.getX(), point.getY()) > reach;
+}
+
+bool CompiledMechanism::isReachable(const Coord2D& point) const
+{
+    const double distance = std::hypot(point.getX(), point.getY());
+    return distance <= reach && distance >= innerReach;
+}
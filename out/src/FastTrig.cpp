@@ -0,0 +1,50 @@
+#include "../include/FastTrig.h"
+#include <cmath>
+
+// pi/2 split so that k * pio2High and k * pio2Mid are exact for |k| < 2^20 (fdlibm's pio2_1, pio2_2, pio2_2t)
+static const double twoOverPi = 6.36619772367581382433e-01;
+static const double pio2High = 1.57079632673412561417e+00;
+static const double pio2Mid = 6.07710050630396597660e-11;
+static const double pio2Low = 2.02226624879595063154e-21;
+static const double roundingShift = 6755399441055744.0; // 1.5 * 2^52: adding and subtracting it rounds to the nearest integer
+
+// minimax polynomials on [-pi/4, pi/4] in z = r^2 (cephes sin.c)
+static const double s1 = -1.66666666666666307295e-01, s2 = 8.33333333332211858878e-03, s3 = -1.98412698295895385996e-04,
+                    s4 = 2.75573136213857245213e-06, s5 = -2.50507477628578072866e-08, s6 = 1.58962301576546568060e-10;
+static const double c1 = 4.16666666666665929218e-02, c2 = -1.38888888888730564116e-03, c3 = 2.48015872888517045348e-05,
+                    c4 = -2.75573141792967388112e-07, c5 = 2.08757008419747316778e-09, c6 = -1.13585365213876817300e-11;
+
+void sinCos(const double* angles, int count, double* cosines, double* sines)
+{
+    // everything, the quadrant included, stays in double arithmetic: integer conversions and selects keep compilers from
+    // vectorizing the loop, and angles the rounding trick cannot handle are redone below anyway
+    for (int i = 0; i < count; i++)
+    {
+        const double x = angles[i];
+        const double k = (x * twoOverPi + roundingShift) - roundingShift; // std::round is a library call on plain x86-64
+        const double r = ((x - k * pio2High) - k * pio2Mid) - k * pio2Low;
+
+        const double quadrant = k - 4.0 * (((k * 0.25 - 0.375) + roundingShift) - roundingShift); // k mod 4, in 0 .. 3
+        const double upper = ((quadrant * 0.5 - 0.25) + roundingShift) - roundingShift;         // quadrant 2 or 3
+        const double odd = quadrant - 2.0 * upper;                                                // quadrant 1 or 3
+
+        const double z = r * r;
+        const double sr = r + r * z * (s1 + z * (s2 + z * (s3 + z * (s4 + z * (s5 + z * s6)))));
+        const double cr = 1.0 - 0.5 * z + z * z * (c1 + z * (c2 + z * (c3 + z * (c4 + z * (c5 + z * c6)))));
+
+        // sin(r + k pi/2) and cos(r + k pi/2) cycle through (s, c), (c, -s), (-s, -c), (-c, s); the 0 / 1 weights are exact
+        const double s = (1.0 - odd) * sr + odd * cr;
+        const double c = (1.0 - odd) * cr + odd * sr;
+        sines[i] = (1.0 - 2.0 * upper) * s;
+        cosines[i] = (1.0 - 2.0 * (odd + upper - 2.0 * odd * upper)) * c; // negative in quadrants 1 and 2
+    }
+
+    for (int i = 0; i < count; i++) // rare: angles the reduction cannot handle, including NaN and infinity
+    {
+        if (!(std::abs(angles[i]) <= sinCosReductionLimit))
+        {
+            cosines[i] = std::cos(angles[i]);
+            sines[i] = std::sin(angles[i]);
+        }
+    }
+}
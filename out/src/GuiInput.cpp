@@ -0,0 +1,100 @@
+// GuiInput.cpp : the readers that fill a MechanismModel and a target Coord2D from the GUI's input fields.
+//                Built into ik_gui, so ik_core and everything linking it stays free of imgui, glfw and OpenGL.
+
+#include "../include/gui.h"
+#include "../include/MechanismModel.h"
+
+// initialize mechanism
+void MechanismModel::initializeMechanism(GUI *gui) 
+{
+    numJoints = getNumberOfJoints(gui);
+    linkLengths = getLinkLengths(gui, numJoints);
+}
+
+// get number of joints from the user 
+int MechanismModel::getNumberOfJoints(GUI *gui) 
+{
+    int numJoints = gui->getJoints();
+
+    //while (true) // prompt user continuously until a valid number of joints is provided
+    //{
+    //    std::cout << "Enter the number of joints in the mechanism:\n";
+    //    std::cout << "Number of joints: ";
+    //    std::cin >> numJoints;
+
+    //    if (std::cin.fail() || numJoints < 1) 
+    //    {
+    //        std::cin.clear();
+    //        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    //        std::cout << "Invalid input. Please enter a number greater than or equal to 1.\n";
+    //    }
+    //    else 
+    //    {
+    //        break;
+    //    }
+    //}
+    return numJoints;
+}
+
+// get link lengths from the user
+std::vector<double> MechanismModel::getLinkLengths(GUI *gui, int numJoints) 
+{
+    std::vector<float> extracted = gui->getLinkLengths();
+    std::vector<double> lengths(extracted.begin(), extracted.end());
+
+    //double length;
+
+    //std::cout << "Enter the lengths for " << numJoints << " links:\n";
+    //for (int i = 0; i < numJoints; i++) // loop for each link in the mechanism defined by the number of joints
+    //{
+    //    while (true) // promt user continuously until a valid length is provided
+    //    {
+    //        std::cout << "Length of link " << i + 1 << ": ";
+    //        std::cin >> length;
+
+    //        if (std::cin.fail() || length <= 0.0) 
+    //        {
+    //            std::cin.clear();
+    //            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    //            std::cout << "Invalid input. Please enter a positive number.\n";
+    //        }
+    //        else 
+    //        {
+    //            lengths.push_back(length);
+    //            break;
+    //        }
+    //    }
+    //}
+    return lengths;
+}
+
+// static method to get valid input
+Coord2D Coord2D::getValidInput(GUI *gui) 
+{
+    double x, y;
+    std::array<float, 2> inputs = gui->getDesiredPosition();
+    x = inputs[0];
+    y = inputs[1];
+    //while (true) 
+    //{
+    //    std::cout << "Enter desired x and y coordinates separated by a space: ";
+
+    //    // read x and y coords
+    //    std::cin >> x >> y;
+
+    //    // check for valid input
+    //    if (std::cin.fail()) 
+    //    {
+    //        std::cin.clear();
+    //        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    //        std::cout << "Invalid input. Please enter numeric values.\n";
+    //    }
+    //    else 
+    //    {
+    //        // valid input
+    //        break;
+    //    }
+    //}
+
+    return Coord2D(x, y);
+}
@@ -0,0 +1,54 @@
+#include "../include/InitialGuess.h"
+#include "../include/Profiler.h"
+
+// seeds newton's method with a configuration that points the mechanism towards the desired point
+Eigen::VectorXd optimizeInitialGuess(const MechanismModel* m, Coord2D point)
+{
+    IK_PROFILE_SCOPE("seed initial guess");
+
+    int numJoints = m->getJoints();
+
+    Eigen::VectorXd initialGuess(numJoints);
+    initialGuess.setZero(); // Default to 0 radians if no better guess found
+
+    double x = point.getX();
+    double y = point.getY();
+
+    // Compute base angle based on desired point's quadrant
+    double baseAngle = atan2(y, x); // Angle to the desired point
+
+    // Scale factor: how much each joint should bend
+    double angleSpread = M_PI / (2.0 * numJoints); // Evenly spread angles
+
+    // Adjust initial guess based on quadrant
+    if (x > 0 && y > 0) { // Quadrant I
+        initialGuess[0] = baseAngle / 2; // Spread rotation
+        for (int i = 1; i < numJoints; i++)
+            initialGuess[i] = angleSpread;
+    }
+    else if (x < 0 && y > 0) { // Quadrant II
+        initialGuess[0] = baseAngle / 2;
+        for (int i = 1; i < numJoints; i++)
+            initialGuess[i] = angleSpread;
+    }
+    else if (x < 0 && y < 0) { // Quadrant III
+        initialGuess[0] = baseAngle / 2;
+        for (int i = 1; i < numJoints; i++)
+            initialGuess[i] = -angleSpread;
+    }
+    else if (x > 0 && y < 0) { // Quadrant IV
+        initialGuess[0] = baseAngle / 2;
+        for (int i = 1; i < numJoints; i++)
+            initialGuess[i] = -angleSpread;
+    }
+    else { // Special cases: (x, y) is exactly on an axis
+        if (x == 0) { // Directly above or below origin
+            initialGuess[0] = (y > 0) ? M_PI / 2 : -M_PI / 2;
+        }
+        else if (y == 0) { // Directly left or right
+            initialGuess[0] = (x > 0) ? 0 : M_PI;
+        }
+    }
+
+    return initialGuess;
+}
@@ -1,7 +1,88 @@
 #include "../include/IterativeSolver.h"
+#include "../include/AllocationTracker.h"
+#include "../include/Profiler.h"
+#include "../include/FastTrig.h"
+#include "../include/ParallelKinematics.h"
+#include "../include/NewtonStepper.h"
+#include <chrono>
+
+bool parseStepControl(const std::string& name, StepControl& control)
+{
+	if (name == "full") control = StepControl::Full;
+	else if (name == "line-search") control = StepControl::LineSearch;
+	else if (name == "trust-region") control = StepControl::TrustRegion;
+	else return false;
+	return true;
+}
+
+bool parseJacobianUpdate(const std::string& name, JacobianUpdate& mode)
+{
+	if (name == "exact") mode = JacobianUpdate::Exact;
+	else if (name == "broyden") mode = JacobianUpdate::Broyden;
+	else if (name == "chord") mode = JacobianUpdate::Chord;
+	else return false;
+	return true;
+}
 
 // constructor
-IterativeSolver::IterativeSolver() {}
+IterativeSolver::IterativeSolver() : id(0), verbose(true), pool(nullptr), stepControl(StepControl::Full) {}
+
+// enables or disables console output while solving; batch callers such as the benchmarks turn it off
+void IterativeSolver::setVerbose(bool enabled)
+{
+	verbose = enabled;
+}
+
+// shares a pool for single chains too long for one core; the pool may be the one running this solver's own task
+void IterativeSolver::setThreadPool(ThreadPool* threadPool)
+{
+	pool = threadPool;
+}
+
+// selects full steps, armijo line search or the dogleg trust region for every newton step
+void IterativeSolver::setStepControl(StepControl control)
+{
+	stepControl = control;
+}
+
+StepControl IterativeSolver::getStepControl() const
+{
+	return stepControl;
+}
+
+// selects exact jacobians, broyden updates or chord reuse for the newton steps
+void IterativeSolver::setJacobianReuse(const JacobianReuse& reuse)
+{
+	jacobianReuse = reuse;
+}
+
+const JacobianReuse& IterativeSolver::getJacobianReuse() const
+{
+	return jacobianReuse;
+}
+
+void IterativeSolver::setTermination(const Termination& criteria)
+{
+	termination = criteria;
+}
+
+const Termination& IterativeSolver::getTermination() const
+{
+	return termination;
+}
+
+// manipulability and collision penalties derive joint positions from the jacobian columns
+bool IterativeSolver::needsExactJacobian() const
+{
+	return objectives.manipulabilityWeight > 0.0 || (objectives.collisionWeight > 0.0 && objectives.collider);
+}
+
+// sets the objectives for the redundant joints; a default constructed SecondaryObjectives switches them off again
+// limits or a rest pose sized for a different chain are ignored by each solve rather than read out of bounds
+void IterativeSolver::setSecondaryObjectives(const SecondaryObjectives& secondary)
+{
+	objectives = secondary;
+}
 
 // function that creates the Homogeneous Transformation matrix that represents the forward kinematics of the mechanism
 
@@ -13,131 +94,245 @@ Eigen::Vector2d IterativeSolver::error(Eigen::Vector2d desiredPosition, Eigen::V
 }
 
 // function that dynamically calculates the position of the mechanism in the 2d plane based on provided vector of joint angles
-Eigen::Vector2d IterativeSolver::endEffectorPosition(MechanismModel *m, Eigen::VectorXd jointAngles)
+Eigen::Vector2d IterativeSolver::endEffectorPosition(const MechanismModel* m, Eigen::VectorXd jointAngles)
 {
-	int joints = m->getJoints();
-	std::vector<double> links = m->getLinks(); // get parameters
+	IK_ALLOCATION_PHASE(ForwardKinematics);
+	IK_PROFILE_SCOPE("forward kinematics");
 
-	Eigen::Vector2d endEffector;
+	const std::vector<double>& links = m->getLinks(); // get parameters
 
-	double x = 0, y = 0, theta = 0;
+	// serial sinCos kernel without a pool or for short chains; forwardKinematics stays for the dual number path
+	return parallelEndEffector(links.data(), jointAngles.data(), static_cast<int>(links.size()), pool);
+}
 
-	for (int i = 0; i < joints; i++) // iteratively construct the position vector for the specifications of the mechanism
+// function that writes the jacobian into a column-major 2 x joints buffer in O(n) without allocating
+// column i is the vector from joint i to the end effector rotated by 90 degrees, so one forward pass stores every link vector
+// and one backward pass turns them into suffix sums
+void IterativeSolver::jacobianKernel(const double* links, const double* jointAngles, int joints, double* J)
+{
+	cumulativeSinCos(0.0, jointAngles, 0, joints, [&](int i, double c, double s) { // link vectors in absolute orientation
+		J[2 * i] = links[i] * c;
+		J[2 * i + 1] = links[i] * s;
+	});
+
+	double x = 0, y = 0;
+	for (int i = joints - 1; i >= 0; i--) // accumulate from the end effector back to the base
 	{
-		theta += jointAngles[i];
-		x += links[i] * std::cos(theta);
-		y += links[i] * std::sin(theta);
+		x += J[2 * i];
+		y += J[2 * i + 1];
+		J[2 * i] = -y; // partial derivative of x with respect to joint i
+		J[2 * i + 1] = x; // partial derivative of y with respect to joint i
 	}
-
-	endEffector << x, y;
-
-	return endEffector;
 }
 
 // function that dynamically calculates the jacobian matrix needed for the iterative step of newton's method
-// many assumptions are being made for this function to work
-Eigen::MatrixXd IterativeSolver::computeJacobian(MechanismModel *m, Eigen::VectorXd jointAngles)
+Eigen::MatrixXd IterativeSolver::computeJacobian(const MechanismModel* m, Eigen::VectorXd jointAngles)
 {
+	IK_ALLOCATION_PHASE(Jacobian);
+	IK_PROFILE_SCOPE("jacobian");
+
 	int joints = m->getJoints();
-	std::vector<double> links = m->getLinks(); // get parameters
+	const std::vector<double>& links = m->getLinks(); // get parameters
 
 	Eigen::MatrixXd J(2, joints);
-	std::vector<std::pair<double, double>> jacobianColumns(joints, { 0.0, 0.0 });
-	double theta = 0, col = 0;
+	if (pool) parallelJacobianKernel(links.data(), jointAngles.data(), joints, J.data(), pool);
+	else jacobianKernel(links.data(), jointAngles.data(), joints, J.data());
+
+	return J;
+}
+
+// function that compares the analytic jacobian against the exact dual number jacobian
+// the deviation is scaled by the largest entry so the tolerance is independent of the link lengths
+double IterativeSolver::checkJacobian(const MechanismModel* m, const Eigen::VectorXd& jointAngles, double tolerance)
+{
+	Eigen::MatrixXd analytic = computeJacobian(m, jointAngles);
+	Eigen::MatrixXd exact = computeJacobianAutoDiff(m, jointAngles);
+
+	double deviation = (analytic - exact).cwiseAbs().maxCoeff() / (1.0 + exact.cwiseAbs().maxCoeff());
+
+	if (deviation > tolerance)
+	{
+		std::cerr << "Jacobian check failed: analytic and dual number jacobians differ by " << deviation << " (tolerance " << tolerance << ").\n";
+	}
+
+	return deviation;
+}
 
-	// for each column in the desired jacobian matrix
-	for (std::pair<double, double> &c : jacobianColumns)
+// function that computes one newton increment; does not calculate the inverse explicitly to avoid O(n^3) time
+void IterativeSolver::computeStep(const MechanismModel* m, const Eigen::VectorXd& q, const Eigen::Vector2d& e, Eigen::MatrixXd& J, Eigen::VectorXd& increment)
+{
+	J = computeJacobian(m, q); // calculate the jacobian
+
+#ifdef IK_CHECK_JACOBIAN
+	checkJacobian(m, q, 1e-9); // cross-check the analytic kernel against the dual number jacobian every iteration
+#endif
+
+	solveStep(q, J, e, increment);
+}
+
+// function that solves J increment = e, with the secondary objectives in the null space of J when they are active
+void IterativeSolver::solveStep(const Eigen::VectorXd& q, const Eigen::MatrixXd& J, const Eigen::Vector2d& e, Eigen::VectorXd& increment)
+{
+	IK_ALLOCATION_PHASE(LinearSolve);
+	IK_PROFILE_SCOPE("step solve");
+	if (objectives.active()) // minimum norm step plus the secondary objectives projected into the null space of J, in O(n)
+	{
+		increment.resize(q.size());
+		secondaryObjectiveGradient(objectives, q.data(), J.data(), static_cast<int>(q.size()), increment.data());
+		nullSpaceStep(J.data(), static_cast<int>(q.size()), e, increment.data(), increment.data());
+	}
+	else
 	{
-		for (int i = 0; i < joints; i++) // for each joint in the mechanism
+		increment = J.colPivHouseholderQr().solve(e); //time versus iterations compared to takng the inverse
+	}
+}
+
+// function that performs newton's method on the mechanism to solve for the joint angles necessary to acheive the desired end-effector position
+// only the answer is kept unless recordTrace is set, in which case every iterate goes into the result's columnar trace
+SolveResult IterativeSolver::newtonSolve(const MechanismModel* m, Eigen::VectorXd initialGuess, Coord2D desiredPosition, double tolerance, double deltaTolerance, bool recordTrace)
+{
+	IK_PROFILE_SCOPE("newton solve");
+
+	NewtonStepper stepper(*this, m, initialGuess, desiredPosition, tolerance, deltaTolerance);
+
+	SolveResult result;
+	if (recordTrace) result.trace.reset(static_cast<int>(initialGuess.size()), 16);
+
+	do // every iterate, including the initial guess
+	{
+		if (recordTrace)
 		{
-			theta += jointAngles[i];
-			if (i < col) // condition for checking what to add to the elements
-			{
-				c.first += 0;
-				c.second += 0;
-			}
-			else
-			{
-				c.first += -1 * links[i] * std::sin(theta); // iteratively construct elements of the Jacobian
-				c.second += links[i] * std::cos(theta);
-			}
+			IK_ALLOCATION_PHASE(History);
+			result.trace.record(stepper.iterate(), stepper.errorNorm(), stepper.stepNorm());
 		}
-		col++;
-	}	
 
-	/*x1 = -1 * links[0] * std::sin(jointAngles[0]) - links[1] * std::sin(jointAngles[0] + jointAngles[1]);
-	x2 = -1 * links[1] * std::sin(jointAngles[0] + jointAngles[1]);
-	y1 = links[0] * std::cos(jointAngles[0]) + links[1] * std::cos(jointAngles[0] + jointAngles[1]);
-	y2 = links[1] * std::cos(jointAngles[0] + jointAngles[1]);*/
+		if (verbose) std::cout << stepper.errorNorm() << "\n";
+	} while (stepper.step());
+
+	result.status = stepper.status();
+	result.solution = stepper.iterate();
+	result.error = stepper.errorNorm();
+	result.iterations = stepper.getIterations();
+	result.evaluations = stepper.getEvaluations();
+	result.jacobians = stepper.getJacobianEvaluations();
 
-	// populate x partial derivatives
-	for (int i = 0; i < size(jacobianColumns); i++)
+	if (verbose && result.converged())
 	{
-		J(0, i) = jacobianColumns[i].first;
-	}
+		Eigen::Vector2d actual = endEffectorPosition(m, result.solution);
+		std::cout << "Converged after " << result.iterations + 1 << " iterations (error norm).\n"; // plot error versus iterations
+		std::cout << "Desired position was " << desiredPosition.getX() << ", " << desiredPosition.getY() << ".\n"; 
+		std::cout << "Actual position was " << actual[0] << ", " << actual[1] << ".\n";
+		std::cout << "The angles calculated to acheive the desired position are ";
 
-	// populate y partial derivatives
-	for (int i = 0; i < size(jacobianColumns); i++)
+		for (int i = 0; i < result.solution.size(); i++)
+		{
+			std::cout << result.solution[i] << ", ";
+		}
+		std::cout << ".\n";
+	}
+	else if (verbose)
 	{
-		J(1, i) = jacobianColumns[i].second;
+		std::cout << "Convergence unstable, aborting...\n";
 	}
 
-	return J;
+	return result;
 }
 
-// function that performs newton's method on the mechanism to solve for the joint angles necessary to acheive the desired end-effector position
-std::vector<Eigen::VectorXd> IterativeSolver::newtonSolve(MechanismModel *m, Eigen::VectorXd initialGuess, Coord2D desiredPosition, double tolerance, double deltaTolerance)
+// function that performs newton's method until convergence or until the budget runs out, whichever comes first
+// one jacobian kernel pass per iteration also yields the end effector position (column 0 is the base to tip vector rotated by 90 degrees),
+// and the step is the minimum norm solution J^T (J J^T)^-1 e through the 2 x 2 matrix J J^T, plus any secondary objectives in the
+// null space of J, so an iteration is O(n) with no allocation
+BoundedSolveResult IterativeSolver::newtonSolveBounded(const MechanismModel* m, const Eigen::Ref<const Eigen::VectorXd>& initialGuess, Coord2D desiredPosition, double tolerance, const SolveBudget& budget, SolverWorkspace& workspace)
 {
-	Eigen::Vector2d desired(desiredPosition.getX(), desiredPosition.getY());
-	Eigen::Vector2d actual = endEffectorPosition(m, initialGuess); // get desired and actual position vectors
-
-	Eigen::VectorXd iterator = initialGuess; // initialize the iterator vector
-	std::vector<Eigen::VectorXd> iterationHistory;
-	int iter = 1;
+	return boundedSolve(m->getLinks().data(), m->getJoints(), initialGuess, desiredPosition, tolerance, budget, workspace);
+}
 
-	while (true) // loop until convergence
+BoundedSolveResult IterativeSolver::newtonSolveBounded(const CompiledMechanism& mechanism, const Eigen::Ref<const Eigen::VectorXd>& initialGuess, Coord2D desiredPosition, double tolerance, const SolveBudget& budget, SolverWorkspace& workspace)
+{
+	if (!mechanism.isReachable(desiredPosition))
 	{
-		Eigen::Vector2d e = error(desired, actual); // calculate error between desired and actual position
+		if (workspace.getJoints() != mechanism.getJoints()) workspace.resize(mechanism.getJoints());
+		workspace.best = initialGuess;
+
+		BoundedSolveResult result;
+		result.status = SolveStatus::Unreachable;
+		return result;
+	}
+	return boundedSolve(mechanism.getLinks(), mechanism.getJoints(), initialGuess, desiredPosition, tolerance, budget, workspace);
+}
+
+BoundedSolveResult IterativeSolver::boundedSolve(const double* links, int joints, const Eigen::Ref<const Eigen::VectorXd>& initialGuess, Coord2D desiredPosition, double tolerance, const SolveBudget& budget, SolverWorkspace& workspace)
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	if (workspace.getJoints() != joints) workspace.resize(joints); // allocates; size the workspace up front to avoid it
+
+	IK_PROFILE_SCOPE("bounded newton solve"); // opened first: a thread's first span allocates its trace buffer
+	IK_NO_ALLOCATION_REGION("bounded newton solve");
+
+	const Eigen::Vector2d desired(desiredPosition.getX(), desiredPosition.getY());
+	Eigen::MatrixXd& J = workspace.J;
+	Eigen::VectorXd& q = workspace.iterate;
 
-		iterationHistory.push_back(iterator); //iterator
+	q = initialGuess;
+	workspace.best = initialGuess;
 
-		std::cout << e.norm() << "\n";
+	BoundedSolveResult result;
+	int sinceImprovement = 0;
+	double slowestIteration = 0.0; // seconds; the deadline check assumes the next iteration may take this long
 
-		if (e.norm() < tolerance) // if convergence
+	for (clock::time_point iterationStart = start; ; )
+	{
+		jacobianKernel(links, q.data(), joints, J.data());
+		const Eigen::Vector2d e = desired - Eigen::Vector2d(J(1, 0), -J(0, 0));
+		const double norm = e.norm();
+
+		if (!std::isfinite(norm))
 		{
-			std::cout << "Converged after " << iter << " iterations (error norm).\n"; // plot error versus iterations
-			std::cout << "Desired position was " << desired[0] << ", " << desired[1] << ".\n"; 
-			std::cout << "Actual position was " << actual[0] << ", " << actual[1] << ".\n";
-			std::cout << "The angles calculated to acheive the desired position are ";
-			
-			for (int i = 0; i < iterator.size(); i++)
-			{
-				std::cout << iterator[i] << ", ";
-			}
-			std::cout << ".\n";
+			result.status = SolveStatus::NonFinite;
 			break;
 		}
 
-		Eigen::MatrixXd J = computeJacobian(m, iterator); // calculate the jacobian
+		if (norm < result.error)
+		{
+			result.error = norm;
+			workspace.best = q;
+			sinceImprovement = 0;
+		}
+		else if (++sinceImprovement >= budget.divergenceWindow)
+		{
+			result.status = SolveStatus::Diverging;
+			break;
+		}
 
-		// how much the newton step is incremented by; does not calculate inverse explicityly to avoid O(n^3) time
-		Eigen::VectorXd increment = J.colPivHouseholderQr().solve(e); //time versus iterations compared to takng the inverse
+		if (norm < tolerance)
+		{
+			result.status = SolveStatus::Converged;
+			break;
+		}
 
-		iterator += increment; // iterative newton step
-		actual = endEffectorPosition(m, iterator); // update actual position based on new angles
-		iter++;
+		const clock::time_point now = clock::now();
+		slowestIteration = std::max(slowestIteration, std::chrono::duration<double>(now - iterationStart).count());
+		iterationStart = now;
 
-		if (iter > 1000)
+		if (result.iterations >= budget.iterations || std::chrono::duration<double>(now - start).count() + slowestIteration > budget.seconds)
 		{
-			std::cout << "Convergence unstable, aborting...\n";
+			result.status = SolveStatus::BudgetExhausted;
 			break;
 		}
+
+		// the increment buffer holds the secondary objective direction until nullSpaceStep overwrites it with the step
+		if (objectives.active()) secondaryObjectiveGradient(objectives, q.data(), J.data(), joints, workspace.increment.data());
+		else workspace.increment.setZero();
+		nullSpaceStep(J.data(), joints, e, workspace.increment.data(), workspace.increment.data());
+		q += workspace.increment;
+		result.iterations++;
 	}
 
-	return iterationHistory;
+	return result;
 }
 
-
 /*
 Goals to have completed by end of january
 
@@ -0,0 +1,128 @@
+#include "../include/KinematicState.h"
+#include "../include/FastTrig.h"
+#include <algorithm>
+#include <cmath>
+
+// constructor; the whole chain starts dirty and is computed on the first read
+KinematicState::KinematicState(const std::vector<double>& linkLengths, const Eigen::VectorXd& jointAngles)
+    : links(linkLengths), angles(jointAngles.data(), jointAngles.data() + jointAngles.size()), dirtyFrom(0)
+{
+    const std::size_t n = links.size();
+    absoluteAngles.resize(n);
+    cosines.resize(n);
+    sines.resize(n);
+    positionX.assign(n + 1, 0.0); // the base never moves
+    positionY.assign(n + 1, 0.0);
+}
+
+int KinematicState::getJoints() const
+{
+    return static_cast<int>(links.size());
+}
+
+double KinematicState::getJointAngle(int joint) const
+{
+    return angles[joint];
+}
+
+const std::vector<double>& KinematicState::getJointAngles() const
+{
+    return angles;
+}
+
+void KinematicState::markDirty(int link)
+{
+    dirtyFrom = std::min(dirtyFrom, link);
+}
+
+void KinematicState::setJointAngle(int joint, double angle)
+{
+    if (angles[joint] == angle) return;
+    angles[joint] = angle;
+    markDirty(joint);
+}
+
+void KinematicState::setJointAngles(const Eigen::VectorXd& jointAngles)
+{
+    const int n = getJoints();
+    int first = 0;
+    while (first < n && angles[first] == jointAngles[first]) first++;
+    if (first == n) return;
+
+    for (int i = first; i < n; i++) angles[i] = jointAngles[i];
+    markDirty(first);
+}
+
+void KinematicState::setLinkLength(int link, double length)
+{
+    if (links[link] == length) return;
+    links[link] = length;
+    markDirty(link);
+}
+
+int KinematicState::pendingLinks() const
+{
+    return getJoints() - dirtyFrom;
+}
+
+// recomputes the dirty suffix from the last clean link
+void KinematicState::refresh() const
+{
+    const int n = getJoints();
+    if (dirtyFrom >= n) return;
+
+    double theta = dirtyFrom > 0 ? absoluteAngles[dirtyFrom - 1] : 0.0;
+    for (int i = dirtyFrom; i < n; i++)
+    {
+        theta += angles[i];
+        absoluteAngles[i] = theta;
+    }
+
+    const int count = n - dirtyFrom; // the absolute angles are cached anyway, so the kernel runs straight off them
+    sinCos(absoluteAngles.data() + dirtyFrom, count, cosines.data() + dirtyFrom, sines.data() + dirtyFrom);
+
+    for (int i = dirtyFrom; i < n; i++)
+    {
+        positionX[i + 1] = positionX[i] + links[i] * cosines[i];
+        positionY[i + 1] = positionY[i] + links[i] * sines[i];
+    }
+
+    dirtyFrom = n;
+}
+
+Eigen::Vector2d KinematicState::endEffector() const
+{
+    refresh();
+    return Eigen::Vector2d(positionX.back(), positionY.back());
+}
+
+Eigen::Vector2d KinematicState::jointPosition(int joint) const
+{
+    refresh();
+    return Eigen::Vector2d(positionX[joint], positionY[joint]);
+}
+
+double KinematicState::absoluteAngle(int link) const
+{
+    refresh();
+    return absoluteAngles[link];
+}
+
+Eigen::Vector2d KinematicState::linkDirection(int link) const
+{
+    refresh();
+    return Eigen::Vector2d(cosines[link], sines[link]);
+}
+
+// column i is the vector from joint i to the end effector rotated by 90 degrees, the same layout as IterativeSolver::jacobianKernel
+void KinematicState::jacobian(double* J) const
+{
+    refresh();
+
+    const int n = getJoints();
+    for (int i = 0; i < n; i++)
+    {
+        J[2 * i] = -(positionY[n] - positionY[i]);
+        J[2 * i + 1] = positionX[n] - positionX[i];
+    }
+}
@@ -0,0 +1,30 @@
+#include "../include/MechanismGeometry.h"
+#include "../include/FastTrig.h"
+
+// build the decimated vertex list for a mechanism
+void buildMechanismVertices(const std::vector<float>& linkLengths, const std::vector<float>& jointAngles, float scale, float minSpacing, std::vector<float>& vertices)
+{
+    vertices.clear(); // keeps capacity, so steady state frames do not allocate
+
+    float x = 0.0f, y = 0.0f;
+    float keptX = 0.0f, keptY = 0.0f;
+    float minSpacingSquared = minSpacing * minSpacing;
+
+    vertices.push_back(x); // base joint at the origin
+    vertices.push_back(y);
+
+    size_t joints = linkLengths.size() < jointAngles.size() ? linkLengths.size() : jointAngles.size();
+    cumulativeSinCos(0.0, jointAngles.data(), 0, static_cast<int>(joints), [&](int i, double c, double s) { // accumulate joint angles
+        x += (linkLengths[i] * scale) * static_cast<float>(c);
+        y += (linkLengths[i] * scale) * static_cast<float>(s);
+
+        float dx = x - keptX, dy = y - keptY;
+        if (static_cast<size_t>(i) + 1 == joints || dx * dx + dy * dy >= minSpacingSquared) // keep the end effector and every joint that moved at least a pixel
+        {
+            vertices.push_back(x);
+            vertices.push_back(y);
+            keptX = x;
+            keptY = y;
+        }
+    });
+}
@@ -0,0 +1,276 @@
+#include "../include/NewtonStepper.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+// step control parameters
+static const double armijoFraction = 1e-4;     // share of the predicted decrease a line search step has to achieve
+static const int maxBacktracks = 20;           // halvings before the line search takes whatever it has
+static const double initialRadius = 1.0;       // radians, over all joints
+static const double maxRadius = 2 * 3.14159265358979323846;
+static const double acceptRatio = 1e-4;        // actual over predicted decrease needed to accept a trust region step
+static const int maxTrustTrials = 8;           // shrinks per step before giving up and staying put
+static const double smallStepProgress = 0.5;   // a step under the step tolerance only ends the solve if it also missed halving the error
+
+// constructor; evaluates the initial guess, which may already be converged
+NewtonStepper::NewtonStepper(IterativeSolver& iterativeSolver, const MechanismModel* mechanism, const Eigen::VectorXd& initialGuess, Coord2D desiredPosition, double errorTolerance, double deltaTolerance)
+    : solver(iterativeSolver), m(mechanism), desired(desiredPosition.getX(), desiredPosition.getY()), tolerance(errorTolerance),
+      stepTolerance(deltaTolerance), termination(iterativeSolver.getTermination()), iterator(initialGuess), stepLength(0.0),
+      radius(initialRadius), iterations(0), evaluations(0), jacobianEvaluations(0), sinceRefresh(0), refreshJacobian(true),
+      freshJacobian(false), nonFinite(false), stallStart(0), lastDirection(0), alternations(0), state(SolveStatus::Running)
+{
+    if (solver.getStepControl() == StepControl::Full)
+    {
+        termination.stallWindow = termination.fullStepStallWindow;
+        termination.oscillationWindow = termination.fullStepOscillationWindow;
+    }
+
+    e = errorAt(iterator);
+    nonFinite = !std::isfinite(e.squaredNorm());
+    bestError = stallReference = e.norm();
+    updateStatus(bestError);
+}
+
+Eigen::Vector2d NewtonStepper::errorAt(const Eigen::VectorXd& q)
+{
+    evaluations++;
+    return solver.error(desired, solver.endEffectorPosition(m, q)); // calculate error between desired and actual position
+}
+
+void NewtonStepper::updateStatus(double previousNorm)
+{
+    [[maybe_unused]] std::int64_t checkStart = IK_PROFILE_NOW();
+    const double norm = e.norm();
+    if (nonFinite) state = SolveStatus::NonFinite;
+    else if (norm < tolerance) state = SolveStatus::Converged;
+    else if (iterations >= termination.maxIterations) state = SolveStatus::BudgetExhausted;
+    else if (iterations > 0) state = checkProgress(norm, previousNorm);
+    IK_PROFILE_SPAN("convergence check", checkStart, IK_PROFILE_NOW());
+}
+
+// early exits after a step that left the solve unconverged; Running when none applies
+// the step check uses the last step tried, so a trust region that keeps rejecting shrinking trials ends here as well; steps
+// from a reused jacobian are left to the refresh they trigger
+SolveStatus NewtonStepper::checkProgress(double norm, double previousNorm)
+{
+    if (freshJacobian && candidate.norm() < stepTolerance && norm > smallStepProgress * previousNorm) return SolveStatus::StepTooSmall;
+
+    const bool significant = norm < (1.0 - termination.stallImprovement) * bestError;
+    bestError = std::min(bestError, norm);
+
+    // a converging zig-zag keeps setting significant new bests; a cycle revisits the same errors and keeps reversing
+    const int direction = (norm > previousNorm) - (norm < previousNorm);
+    if (significant) alternations = 0;
+    else if (direction != 0 && direction == -lastDirection) alternations++;
+    else alternations = 0;
+    lastDirection = direction;
+    if (termination.oscillationWindow > 0 && alternations >= termination.oscillationWindow) return SolveStatus::Oscillating;
+
+    if (termination.stallWindow > 0 && iterations - stallStart >= termination.stallWindow)
+    {
+        if (bestError > (1.0 - termination.stallImprovement) * stallReference) return SolveStatus::Stalled;
+        stallReference = bestError;
+        stallStart = iterations;
+    }
+    return SolveStatus::Running;
+}
+
+// moves to trial, unless its error is not finite: then the iterate stays and the solve ends with NonFinite
+void NewtonStepper::accept(const Eigen::Vector2d& trialError)
+{
+    if (!std::isfinite(trialError.squaredNorm()))
+    {
+        nonFinite = true;
+        stepLength = 0.0;
+        return;
+    }
+    iterator.swap(trial);
+    e = trialError;
+    stepLength = candidate.norm();
+}
+
+bool NewtonStepper::step()
+{
+    if (done()) return false;
+
+    const JacobianReuse& reuse = solver.getJacobianReuse();
+    if (refreshJacobian || reuse.mode == JacobianUpdate::Exact || sinceRefresh >= reuse.refreshInterval || solver.needsExactJacobian())
+    {
+        solver.computeStep(m, iterator, e, J, increment);
+        jacobianEvaluations++;
+        sinceRefresh = 0;
+        refreshJacobian = false;
+        freshJacobian = true;
+    }
+    else
+    {
+        solver.solveStep(iterator, J, e, increment); // J carried over from the last iteration
+        freshJacobian = false;
+    }
+    sinceRefresh++;
+
+    const Eigen::Vector2d previousError = e;
+
+    switch (solver.getStepControl())
+    {
+        case StepControl::Full:
+            candidate = increment;
+            trial = iterator + candidate; // iterative newton step
+            accept(errorAt(trial));
+            break;
+        case StepControl::LineSearch:
+            lineSearch();
+            break;
+        case StepControl::TrustRegion:
+            trustRegion();
+            break;
+    }
+
+    updateJacobian(previousError);
+    iterations++;
+    updateStatus(previousError.norm());
+    return true;
+}
+
+// after a step: flag a refresh when the jacobian in use made too little progress, otherwise apply the broyden update
+void NewtonStepper::updateJacobian(const Eigen::Vector2d& previousError)
+{
+    const JacobianReuse& reuse = solver.getJacobianReuse();
+    if (reuse.mode == JacobianUpdate::Exact) return;
+
+    // the negated comparison also catches a non-finite error
+    if (stepLength == 0.0 || !(e.norm() <= reuse.slowdownRatio * previousError.norm()))
+    {
+        refreshJacobian = true;
+        return;
+    }
+
+    if (reuse.mode == JacobianUpdate::Broyden)
+    {
+        // secant condition J s = observed end effector motion; the correction is rank one, so O(n) for a 2 x n jacobian
+        const Eigen::Vector2d moved = previousError - e;
+        const Eigen::Vector2d mismatch = moved - J * candidate;
+        J.noalias() += (mismatch / candidate.squaredNorm()) * candidate.transpose();
+    }
+}
+
+// backtracking on the squared error; the newton step solves J d = e, so along d the squared error falls at twice its value
+void NewtonStepper::lineSearch()
+{
+    const double f = e.squaredNorm();
+    double alpha = 1.0;
+
+    for (int attempt = 0; ; attempt++)
+    {
+        candidate = alpha * increment;
+        trial = iterator + candidate;
+        Eigen::Vector2d trialError = errorAt(trial);
+
+        if (trialError.squaredNorm() <= (1.0 - 2.0 * armijoFraction * alpha) * f || attempt + 1 >= maxBacktracks)
+        {
+            accept(trialError);
+            return;
+        }
+        alpha *= 0.5;
+    }
+}
+
+// dogleg inside a radius around the iterate, using the linear model e - J p of the error after a step p
+// the path runs from the iterate to the steepest descent (cauchy) point and on to the newton step; the radius grows when the
+// model predicts the decrease well and shrinks when it does not
+void NewtonStepper::trustRegion()
+{
+    const double f = e.squaredNorm();
+    const double newtonLength = increment.norm();
+
+    gradient.noalias() = J.transpose() * e;
+    const double gradientSquared = gradient.squaredNorm();
+    const Eigen::Vector2d Jg = J * gradient;
+
+    for (int attempt = 0; attempt < maxTrustTrials; attempt++)
+    {
+        if (newtonLength <= radius)
+        {
+            candidate = increment;
+        }
+        else if (gradientSquared == 0.0 || Jg.squaredNorm() == 0.0)
+        {
+            candidate = (radius / newtonLength) * increment; // no descent information; shorten the newton step
+        }
+        else
+        {
+            const double cauchyLength = gradientSquared / Jg.squaredNorm() * std::sqrt(gradientSquared);
+            if (cauchyLength >= radius)
+            {
+                candidate = (radius / std::sqrt(gradientSquared)) * gradient;
+            }
+            else
+            {
+                // the point on the segment from the cauchy point to the newton step that lies on the boundary
+                candidate = (gradientSquared / Jg.squaredNorm()) * gradient; // cauchy point
+                trial = increment - candidate;
+                const double a = trial.squaredNorm(), b = 2.0 * candidate.dot(trial), c = candidate.squaredNorm() - radius * radius;
+                const double tau = a > 0.0 ? (-b + std::sqrt(std::max(b * b - 4.0 * a * c, 0.0))) / (2.0 * a) : 0.0;
+                candidate += std::clamp(tau, 0.0, 1.0) * trial;
+            }
+        }
+
+        const double predicted = f - (e - J * candidate).squaredNorm();
+        trial = iterator + candidate;
+        Eigen::Vector2d trialError = errorAt(trial);
+        const double actual = f - trialError.squaredNorm();
+        const double ratio = predicted > 0.0 ? actual / predicted : -1.0;
+
+        const double length = candidate.norm();
+        if (!(ratio >= 0.25)) radius = 0.25 * length; // also shrinks after a non-finite trial error
+        else if (ratio > 0.75 && length >= 0.99 * radius) radius = std::min(2.0 * radius, maxRadius);
+
+        if (ratio > acceptRatio)
+        {
+            accept(trialError);
+            return;
+        }
+    }
+
+    stepLength = 0.0; // every trial rejected; the smaller radius is tried again next step
+}
+
+bool NewtonStepper::done() const
+{
+    return state != SolveStatus::Running;
+}
+
+SolveStatus NewtonStepper::status() const
+{
+    return state;
+}
+
+const Eigen::VectorXd& NewtonStepper::iterate() const
+{
+    return iterator;
+}
+
+double NewtonStepper::errorNorm() const
+{
+    return e.norm();
+}
+
+double NewtonStepper::stepNorm() const
+{
+    return stepLength;
+}
+
+int NewtonStepper::getIterations() const
+{
+    return iterations;
+}
+
+int NewtonStepper::getEvaluations() const
+{
+    return evaluations;
+}
+
+int NewtonStepper::getJacobianEvaluations() const
+{
+    return jacobianEvaluations;
+}
@@ -0,0 +1,114 @@
+#include "../include/ParallelKinematics.h"
+#include "../include/FastTrig.h"
+#include "../include/IterativeSolver.h"
+#include "../include/Profiler.h"
+#include <cmath>
+#include <vector>
+
+// block boundaries for splitting joints into count nearly equal blocks
+static int blockBegin(int block, int count, int joints)
+{
+    return static_cast<int>(static_cast<long long>(joints) * block / count);
+}
+
+// runs the first two scan phases: per block angle totals, their exclusive scan, then per block link vector sums
+// when J is given the link vectors are also stored in it for the jacobian's backward pass
+static void scanLinkVectors(const double* links, const double* jointAngles, int joints, double* J, ThreadPool& pool, int blocks, std::vector<Eigen::Vector2d>& blockSums)
+{
+    std::vector<double> blockAngles(blocks);
+    pool.parallelFor(0, blocks, 1, [&](int first, int last) {
+        for (int b = first; b < last; b++)
+        {
+            double sum = 0;
+            for (int i = blockBegin(b, blocks, joints); i < blockBegin(b + 1, blocks, joints); i++) sum += jointAngles[i];
+            blockAngles[b] = sum;
+        }
+    });
+
+    double start = 0; // exclusive scan, so each entry becomes the absolute angle before the block's first joint
+    for (double& angle : blockAngles)
+    {
+        double total = angle;
+        angle = start;
+        start += total;
+    }
+
+    pool.parallelFor(0, blocks, 1, [&](int first, int last) {
+        for (int b = first; b < last; b++)
+        {
+            double x = 0, y = 0;
+            cumulativeSinCos(blockAngles[b], jointAngles, blockBegin(b, blocks, joints), blockBegin(b + 1, blocks, joints), [&](int i, double c, double s) {
+                double dx = links[i] * c, dy = links[i] * s;
+                x += dx;
+                y += dy;
+                if (J)
+                {
+                    J[2 * i] = dx;
+                    J[2 * i + 1] = dy;
+                }
+            });
+            blockSums[b] = Eigen::Vector2d(x, y);
+        }
+    });
+}
+
+Eigen::Vector2d parallelEndEffector(const double* links, const double* jointAngles, int joints, ThreadPool* pool, int minJoints)
+{
+    if (!pool || pool->size() < 2 || joints < minJoints)
+    {
+        double x = 0, y = 0;
+        cumulativeSinCos(0.0, jointAngles, 0, joints, [&](int i, double c, double s) {
+            x += links[i] * c;
+            y += links[i] * s;
+        });
+        return Eigen::Vector2d(x, y);
+    }
+
+    IK_PROFILE_SCOPE("parallel forward kinematics");
+
+    const int blocks = static_cast<int>(pool->size());
+    std::vector<Eigen::Vector2d> blockSums(blocks);
+    scanLinkVectors(links, jointAngles, joints, nullptr, *pool, blocks, blockSums);
+
+    Eigen::Vector2d endEffector = Eigen::Vector2d::Zero();
+    for (const Eigen::Vector2d& sum : blockSums) endEffector += sum;
+    return endEffector;
+}
+
+void parallelJacobianKernel(const double* links, const double* jointAngles, int joints, double* J, ThreadPool* pool, int minJoints)
+{
+    if (!pool || pool->size() < 2 || joints < minJoints)
+    {
+        IterativeSolver::jacobianKernel(links, jointAngles, joints, J);
+        return;
+    }
+
+    IK_PROFILE_SCOPE("parallel jacobian");
+
+    const int blocks = static_cast<int>(pool->size());
+    std::vector<Eigen::Vector2d> blockSums(blocks);
+    scanLinkVectors(links, jointAngles, joints, J, *pool, blocks, blockSums);
+
+    // exclusive scan from the tip: each entry becomes the vector from the end of its block to the end effector
+    Eigen::Vector2d beyond = Eigen::Vector2d::Zero();
+    for (int b = blocks - 1; b >= 0; b--)
+    {
+        Eigen::Vector2d total = blockSums[b];
+        blockSums[b] = beyond;
+        beyond += total;
+    }
+
+    pool->parallelFor(0, blocks, 1, [&](int first, int last) {
+        for (int b = first; b < last; b++)
+        {
+            double x = blockSums[b].x(), y = blockSums[b].y();
+            for (int i = blockBegin(b + 1, blocks, joints) - 1; i >= blockBegin(b, blocks, joints); i--)
+            {
+                x += J[2 * i];
+                y += J[2 * i + 1];
+                J[2 * i] = -y;
+                J[2 * i + 1] = x;
+            }
+        }
+    });
+}
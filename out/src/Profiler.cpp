@@ -0,0 +1,94 @@
+#include "../include/Profiler.h"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// events recorded by one thread; owned by the registry so they outlive the thread
+struct ThreadTraceBuffer
+{
+    int threadId;
+    std::unique_ptr<TraceEvent[]> events; // traceCapacity slots
+    std::uint64_t recorded = 0;           // spans since the last clear; slot recorded % traceCapacity is written next
+
+    std::uint64_t first() const { return recorded > Profiler::traceCapacity ? recorded - Profiler::traceCapacity : 0; } // oldest kept
+    const TraceEvent& at(std::uint64_t i) const { return events[i & (Profiler::traceCapacity - 1)]; }
+};
+
+static std::mutex registryMutex;
+static std::vector<std::shared_ptr<ThreadTraceBuffer>> registry;
+
+// registers the calling thread's buffer on first use; recording itself takes no lock
+static ThreadTraceBuffer& threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadTraceBuffer> buffer;
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadTraceBuffer>();
+        buffer->events.reset(new TraceEvent[Profiler::traceCapacity]);
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->threadId = static_cast<int>(registry.size()) + 1;
+        registry.push_back(buffer);
+    }
+    return *buffer;
+}
+
+std::int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::registerThread()
+{
+    threadBuffer();
+}
+
+void Profiler::record(const char* name, std::int64_t startNs, std::int64_t endNs)
+{
+    ThreadTraceBuffer& buffer = threadBuffer();
+    buffer.events[buffer.recorded++ & (traceCapacity - 1)] = { name, startNs, endNs - startNs };
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : registry)
+    {
+        buffer->recorded = 0;
+    }
+}
+
+// complete ("X") events with microsecond timestamps relative to the earliest span
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::int64_t origin = INT64_MAX;
+    for (auto& buffer : registry)
+    {
+        for (std::uint64_t i = buffer->first(); i < buffer->recorded; i++)
+        {
+            if (buffer->at(i).startNs < origin) origin = buffer->at(i).startNs;
+        }
+    }
+
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    for (auto& buffer : registry)
+    {
+        for (std::uint64_t i = buffer->first(); i < buffer->recorded; i++)
+        {
+            const TraceEvent& e = buffer->at(i);
+            file << (first ? "" : ",\n") << "{\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+                 << ", \"ts\": " << (e.startNs - origin) / 1000.0 << ", \"dur\": " << e.durationNs / 1000.0 << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,97 @@
+#include "../include/SecondaryObjectives.h"
+#include "../include/CollisionScene.h"
+#include <cmath>
+
+bool SecondaryObjectives::active() const
+{
+    return jointLimitWeight > 0.0 || restPoseWeight > 0.0 || manipulabilityWeight > 0.0 || (collisionWeight > 0.0 && collider);
+}
+
+// gradient of sqrt(det(J J^T)) added into z
+// with X_i, Y_i the vector from joint i to the end effector, column i of J is (-Y_i, X_i) and J J^T = [a b; b c] with
+// a = sum Y_i^2, b = -sum X_i Y_i, c = sum X_i^2. Rotating joint k turns every suffix vector from k on by 90 degrees, so
+// the derivatives of a, b and c only need prefix sums of X and Y before k and suffix sums of XY, XX and YY from k on;
+// the suffix sums are the totals minus a running prefix, which keeps the whole gradient to two passes
+static void addManipulabilityGradient(double weight, const double* J, int joints, double* z)
+{
+    double a = 0, b = 0, c = 0;
+    for (int i = 0; i < joints; i++)
+    {
+        const double X = J[2 * i + 1], Y = -J[2 * i];
+        a += Y * Y;
+        b -= X * Y;
+        c += X * X;
+    }
+
+    const double det = a * c - b * b;
+    if (det < 1e-12) return; // singular: the gradient of the square root is unbounded; joint limits or rest pose pull it out instead
+    const double scale = weight / (2.0 * std::sqrt(det));
+
+    double prefixX = 0, prefixY = 0;     // sums over i < k
+    double suffixXY = -b, suffixXX = c, suffixYY = a; // sums over i >= k
+    for (int k = 0; k < joints; k++)
+    {
+        const double X = J[2 * k + 1], Y = -J[2 * k];
+
+        const double da = 2.0 * (X * prefixY + suffixXY);
+        const double dc = -2.0 * (Y * prefixX + suffixXY);
+        const double db = Y * prefixY + suffixYY - X * prefixX - suffixXX;
+        z[k] += scale * (da * c + a * dc - 2.0 * b * db);
+
+        prefixX += X;
+        prefixY += Y;
+        suffixXY -= X * Y;
+        suffixXX -= X * X;
+        suffixYY -= Y * Y;
+    }
+}
+
+void secondaryObjectiveGradient(const SecondaryObjectives& objectives, const double* q, const double* J, int joints, double* z)
+{
+    for (int i = 0; i < joints; i++) z[i] = 0.0;
+
+    // the limits and the rest pose come from the caller and are only read when they hold one entry per joint
+    if (objectives.jointLimitWeight > 0.0 && objectives.lowerLimits.size() == joints && objectives.upperLimits.size() == joints)
+    {
+        // gradient of -sum ((q_i - mid_i) / half range_i)^2; unbounded joints contribute nothing
+        for (int i = 0; i < joints; i++)
+        {
+            const double halfRange = (objectives.upperLimits[i] - objectives.lowerLimits[i]) / 2;
+            if (!std::isfinite(halfRange) || halfRange <= 0.0) continue;
+            const double middle = (objectives.upperLimits[i] + objectives.lowerLimits[i]) / 2;
+            z[i] -= objectives.jointLimitWeight * (q[i] - middle) / (halfRange * halfRange);
+        }
+    }
+
+    if (objectives.restPoseWeight > 0.0 && objectives.restPose.size() == joints)
+    {
+        for (int i = 0; i < joints; i++) z[i] -= objectives.restPoseWeight * (q[i] - objectives.restPose[i]);
+    }
+
+    if (objectives.manipulabilityWeight > 0.0) addManipulabilityGradient(objectives.manipulabilityWeight, J, joints, z);
+
+    if (objectives.collisionWeight > 0.0 && objectives.collider)
+    {
+        objectives.collider->detect(J, joints);
+        objectives.collider->addPenaltyGradient(objectives.collisionWeight, z);
+    }
+}
+
+void nullSpaceStep(const double* J, int joints, const Eigen::Vector2d& e, const double* z, double* step)
+{
+    // J J^T and J z in one pass
+    Eigen::Matrix2d JJt = Eigen::Matrix2d::Zero();
+    Eigen::Vector2d Jz = Eigen::Vector2d::Zero();
+    for (int i = 0; i < joints; i++)
+    {
+        const Eigen::Vector2d column(J[2 * i], J[2 * i + 1]);
+        JJt += column * column.transpose();
+        Jz += column * z[i];
+    }
+
+    // a stretched or folded arm makes J J^T singular; a tiny damping term keeps the step bounded
+    if (std::abs(JJt.determinant()) < 1e-12) JJt += Eigen::Matrix2d::Identity() * 1e-6;
+    const Eigen::Vector2d y = JJt.inverse() * (e - Jz);
+
+    for (int i = 0; i < joints; i++) step[i] = z[i] + J[2 * i] * y[0] + J[2 * i + 1] * y[1];
+}
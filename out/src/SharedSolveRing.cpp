@@ -0,0 +1,439 @@
+#include "../include/SharedSolveRing.h"
+#include "../include/InitialGuess.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "ring words must be address free to work across processes");
+
+static const long sleepSliceNanoseconds = 10'000'000; // sleepers recheck whether the solver is still running this often
+
+static std::size_t cacheLines(std::size_t bytes)
+{
+    return (bytes + 63) / 64 * 64;
+}
+
+static std::size_t slotStride(std::uint32_t joints)
+{
+    return sizeof(SharedSlot) + 2 * cacheLines(joints * sizeof(double));
+}
+
+static double* slotGuess(SharedSlot* slot)
+{
+    return reinterpret_cast<double*>(reinterpret_cast<char*>(slot) + sizeof(SharedSlot));
+}
+
+static double* slotSolution(SharedSlot* slot, std::uint32_t joints)
+{
+    return slotGuess(slot) + cacheLines(joints * sizeof(double)) / sizeof(double);
+}
+
+static double* ringLinks(SharedRingHeader* header)
+{
+    return reinterpret_cast<double*>(header + 1);
+}
+
+static std::size_t segmentSize(std::uint32_t slots, std::uint32_t joints)
+{
+    return sizeof(SharedRingHeader) + cacheLines(joints * sizeof(double)) + slots * slotStride(joints);
+}
+
+static SharedSlot* ringSlot(SharedRingHeader* header, const SharedRingLayout& layout, std::uint32_t position)
+{
+    char* first = reinterpret_cast<char*>(header) + sizeof(SharedRingHeader) + cacheLines(layout.joints * sizeof(double));
+    return reinterpret_cast<SharedSlot*>(first + (position & (layout.slots - 1)) * layout.slotBytes);
+}
+
+// process shared futex: no FUTEX_PRIVATE_FLAG, the word lives in a mapping other processes share
+static void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected)
+{
+    timespec slice = { 0, sleepSliceNanoseconds };
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &slice, nullptr, 0);
+}
+
+static void futexWakeAll(std::atomic<std::uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+static void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// constructor; nothing is shared until start()
+SharedRingServer::SharedRingServer(const std::vector<double>& links, unsigned threads, int parallelThreshold, RingWait ringWait)
+    : descriptor(-1), header(nullptr), mechanism(links), wait(ringWait), parallelBatch(std::max(parallelThreshold, 1)), stopping(false)
+{
+    solver.setVerbose(false);
+    if (threads > 1) pool = std::make_unique<ThreadPool>(threads);
+
+    const unsigned chunks = pool ? pool->size() : 0;
+    for (unsigned i = 0; i <= chunks; i++) workspaces.push_back(std::make_unique<SolverWorkspace>(mechanism.getJoints()));
+}
+
+SharedRingServer::~SharedRingServer()
+{
+    stop();
+}
+
+// whether a solver that is still alive serves the segment at name; a ring it left behind when it crashed does not count
+static bool servedByLiveSolver(const std::string& name)
+{
+    const int existing = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (existing < 0) return false;
+
+    bool live = false;
+    struct stat status;
+    if (fstat(existing, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(SharedRingHeader))
+    {
+        void* mapping = mmap(nullptr, sizeof(SharedRingHeader), PROT_READ, MAP_SHARED, existing, 0);
+        if (mapping != MAP_FAILED)
+        {
+            const SharedRingHeader* other = static_cast<const SharedRingHeader*>(mapping);
+            live = other->magic.load(std::memory_order_acquire) == sharedRingMagic && other->solverRunning.load() != 0;
+            if (live && other->version == sharedRingVersion) live = kill(other->solverPid, 0) == 0 || errno == EPERM;
+            munmap(mapping, sizeof(SharedRingHeader));
+        }
+    }
+    ::close(existing);
+    return live;
+}
+
+bool SharedRingServer::start(const std::string& segmentName, std::uint32_t slots)
+{
+    std::uint32_t count = 4;
+    while (count < slots) count *= 2;
+
+    const std::uint32_t joints = static_cast<std::uint32_t>(mechanism.getJoints());
+    const std::size_t bytes = segmentSize(count, joints);
+
+    name = segmentName[0] == '/' ? segmentName : "/" + segmentName;
+    if (servedByLiveSolver(name))
+    {
+        std::cerr << "Another solver is already serving " << name << ".\n";
+        return false;
+    }
+    shm_unlink(name.c_str()); // a segment left by a solver that died; clients attached to it keep their own mapping
+    descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (descriptor < 0 || ftruncate(descriptor, static_cast<off_t>(bytes)) != 0)
+    {
+        std::cerr << "Could not create shared memory segment " << name << ": " << std::strerror(errno) << "\n";
+        if (descriptor >= 0) ::close(descriptor);
+        shm_unlink(name.c_str());
+        descriptor = -1;
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Could not map shared memory segment " << name << ": " << std::strerror(errno) << "\n";
+        ::close(descriptor);
+        shm_unlink(name.c_str());
+        descriptor = -1;
+        return false;
+    }
+
+    // ftruncate zero fills, so only the non-zero fields need setting; magic goes last so clients never see a half built ring
+    header = static_cast<SharedRingHeader*>(mapping);
+    layout.slots = count;
+    layout.joints = joints;
+    layout.slotBytes = slotStride(joints);
+    layout.segmentBytes = bytes;
+    header->version = sharedRingVersion;
+    header->slots = layout.slots;
+    header->joints = layout.joints;
+    header->slotBytes = layout.slotBytes;
+    header->segmentBytes = layout.segmentBytes;
+    header->fingerprint = mechanism.getFingerprint();
+    header->solverPid = static_cast<std::int32_t>(getpid());
+    std::copy(mechanism.getLinks(), mechanism.getLinks() + joints, ringLinks(header));
+    for (std::uint32_t i = 0; i < count; i++) ringSlot(header, layout, i)->sequence.store(i, std::memory_order_relaxed);
+    header->solverRunning.store(1, std::memory_order_relaxed);
+    header->magic.store(sharedRingMagic, std::memory_order_release);
+
+    stopping.store(false);
+    thread = std::thread(&SharedRingServer::run, this);
+    return true;
+}
+
+void SharedRingServer::stop()
+{
+    if (!header) return;
+
+    stopping.store(true);
+    header->requestSignal.fetch_add(1);
+    futexWakeAll(header->requestSignal);
+    thread.join();
+
+    header->solverRunning.store(0);
+    for (std::uint32_t i = 0; i < layout.slots; i++) futexWakeAll(ringSlot(header, layout, i)->sequence); // sleepers see the solver gone
+
+    munmap(header, layout.segmentBytes);
+    ::close(descriptor);
+    shm_unlink(name.c_str());
+    header = nullptr;
+    descriptor = -1;
+}
+
+// sleeps until the slot at position is requested or the server stops; the dekker pairing of solverSleeping with the
+// producers' requestSignal bump means a submit is either seen by the recheck or wakes the futex
+void SharedRingServer::waitForRequest(std::uint32_t position)
+{
+    SharedSlot* slot = ringSlot(header, layout, position);
+    for (int spin = 0; wait.spinIterations < 0 || spin < wait.spinIterations; spin++)
+    {
+        if (slot->sequence.load(std::memory_order_acquire) == position + 1 || stopping.load(std::memory_order_relaxed)) return;
+        cpuRelax();
+    }
+
+    const std::uint32_t signal = header->requestSignal.load();
+    header->solverSleeping.store(1);
+    if (slot->sequence.load() != position + 1 && !stopping.load()) futexWait(header->requestSignal, signal);
+    header->solverSleeping.store(0, std::memory_order_relaxed);
+}
+
+void SharedRingServer::solveSlot(SharedSlot& slot, SolverWorkspace& workspace)
+{
+    const int joints = static_cast<int>(layout.joints);
+    Coord2D target(slot.targetX, slot.targetY);
+
+    SolveBudget budget;
+    budget.seconds = slot.seconds;
+    budget.iterations = slot.maxIterations;
+
+    BoundedSolveResult result;
+    if (slot.flags & sharedSlotHasGuess)
+    {
+        result = solver.newtonSolveBounded(mechanism, Eigen::Map<const Eigen::VectorXd>(slotGuess(&slot), joints), target, slot.tolerance, budget, workspace);
+    }
+    else
+    {
+        result = solver.newtonSolveBounded(mechanism, optimizeInitialGuess(&mechanism.getModel(), target), target, slot.tolerance, budget, workspace);
+    }
+
+    std::copy(workspace.best.data(), workspace.best.data() + joints, slotSolution(&slot, layout.joints));
+    slot.status = static_cast<std::int32_t>(result.status);
+    slot.iterations = result.iterations;
+    slot.error = result.error;
+}
+
+// the single consumer: takes every consecutive requested slot from the head, solves them and hands each one back
+void SharedRingServer::run()
+{
+    std::uint32_t head = 0;
+
+    while (!stopping.load(std::memory_order_relaxed))
+    {
+        std::uint32_t ready = 0;
+        while (ready < layout.slots && ringSlot(header, layout, head + ready)->sequence.load(std::memory_order_acquire) == head + ready + 1) ready++;
+
+        if (ready == 0)
+        {
+            waitForRequest(head);
+            continue;
+        }
+
+        if (pool && static_cast<int>(ready) >= parallelBatch)
+        {
+            const int grain = static_cast<int>((ready + pool->size() - 1) / pool->size());
+            pool->parallelFor(0, static_cast<int>(ready), grain, [&](int first, int last) {
+                SolverWorkspace& workspace = *workspaces[1 + first / grain];
+                for (int i = first; i < last; i++) solveSlot(*ringSlot(header, layout, head + i), workspace);
+            });
+        }
+        else
+        {
+            for (std::uint32_t i = 0; i < ready; i++) solveSlot(*ringSlot(header, layout, head + i), *workspaces[0]);
+        }
+
+        for (std::uint32_t i = 0; i < ready; i++)
+        {
+            SharedSlot* slot = ringSlot(header, layout, head + i);
+            slot->sequence.store(head + i + 2); // solved; seq_cst pairs with the client's waiters bump
+            if (slot->waiters.load() > 0) futexWakeAll(slot->sequence);
+        }
+        head += ready;
+    }
+}
+
+// constructor; not attached
+SharedRingClient::SharedRingClient(RingWait ringWait) : header(nullptr), wait(ringWait) {}
+
+SharedRingClient::~SharedRingClient()
+{
+    detach();
+}
+
+bool SharedRingClient::attach(const std::string& segmentName)
+{
+    detach();
+
+    const std::string name = segmentName[0] == '/' ? segmentName : "/" + segmentName;
+    int descriptor = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (descriptor < 0) return false;
+
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(descriptor, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(SharedRingHeader))
+    {
+        mapping = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, 0);
+    }
+    ::close(descriptor); // the mapping keeps the segment alive
+
+    if (mapping == MAP_FAILED) return false;
+    header = static_cast<SharedRingHeader*>(mapping);
+    layout.segmentBytes = info.st_size;
+
+    // the dimensions are copied once and must describe exactly the mapped segment, so no later slot address can leave it
+    if (header->magic.load(std::memory_order_acquire) != sharedRingMagic || header->version != sharedRingVersion)
+    {
+        detach();
+        return false;
+    }
+    layout.slots = header->slots;
+    layout.joints = header->joints;
+    layout.slotBytes = header->slotBytes;
+    const bool powerOfTwo = layout.slots >= 4 && (layout.slots & (layout.slots - 1)) == 0;
+    if (!powerOfTwo || layout.joints == 0 || layout.joints > (1u << 20) || layout.slotBytes != slotStride(layout.joints) ||
+        header->segmentBytes != layout.segmentBytes || segmentSize(layout.slots, layout.joints) != layout.segmentBytes)
+    {
+        detach();
+        return false;
+    }
+    return true;
+}
+
+void SharedRingClient::detach()
+{
+    if (header) munmap(header, layout.segmentBytes);
+    header = nullptr;
+    layout = SharedRingLayout();
+}
+
+int SharedRingClient::getJoints() const
+{
+    return static_cast<int>(layout.joints);
+}
+
+std::uint64_t SharedRingClient::getFingerprint() const
+{
+    return header ? header->fingerprint : 0;
+}
+
+// bounded mpmc enqueue (vyukov) reduced to claiming: a slot is free for ticket position when its sequence equals position
+bool SharedRingClient::acquire(RingTicket& ticket)
+{
+    std::uint32_t position = header->enqueuePosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        SharedSlot* slot = ringSlot(header, layout, position);
+        const std::int32_t lag = static_cast<std::int32_t>(slot->sequence.load(std::memory_order_acquire) - position);
+
+        if (lag == 0)
+        {
+            if (header->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (lag < 0)
+        {
+            return false; // still owned by the previous lap
+        }
+        else
+        {
+            position = header->enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    ticket.position = position;
+    ticket.slot = ringSlot(header, layout, position);
+    ticket.guess = slotGuess(ticket.slot);
+    ticket.solution = slotSolution(ticket.slot, layout.joints);
+    return true;
+}
+
+void SharedRingClient::submit(RingTicket& ticket, Coord2D target, double tolerance, bool hasGuess, const SolveBudget& budget)
+{
+    SharedSlot* slot = ticket.slot;
+    slot->targetX = target.getX();
+    slot->targetY = target.getY();
+    slot->tolerance = tolerance;
+    slot->seconds = budget.seconds;
+    slot->maxIterations = budget.iterations;
+    slot->flags = hasGuess ? sharedSlotHasGuess : 0;
+
+    slot->sequence.store(ticket.position + 1, std::memory_order_release);
+    header->requestSignal.fetch_add(1);
+    if (header->solverSleeping.load()) futexWakeAll(header->requestSignal);
+}
+
+bool SharedRingClient::waitFor(const RingTicket& ticket)
+{
+    SharedSlot* slot = ticket.slot;
+    const std::uint32_t solved = ticket.position + 2;
+
+    for (int spin = 0; wait.spinIterations < 0 || spin < wait.spinIterations; spin++)
+    {
+        if (slot->sequence.load(std::memory_order_acquire) == solved) return true;
+        if ((spin & 1023) == 0 && !header->solverRunning.load(std::memory_order_relaxed)) return false;
+        cpuRelax();
+    }
+
+    slot->waiters.fetch_add(1);
+    while (slot->sequence.load() != solved)
+    {
+        if (!header->solverRunning.load())
+        {
+            slot->waiters.fetch_sub(1);
+            return false;
+        }
+        futexWait(slot->sequence, ticket.position + 1);
+    }
+    slot->waiters.fetch_sub(1);
+    return true;
+}
+
+void SharedRingClient::release(RingTicket& ticket)
+{
+    ticket.slot->sequence.store(ticket.position + layout.slots, std::memory_order_release); // free for the next lap
+    ticket.slot = nullptr;
+    ticket.guess = nullptr;
+    ticket.solution = nullptr;
+}
+
+BoundedSolveResult SharedRingClient::solve(Coord2D target, double tolerance, const Eigen::VectorXd* guess, Eigen::VectorXd& solution, const SolveBudget& budget)
+{
+    BoundedSolveResult result;
+    const int joints = getJoints();
+    if (!header || (guess && guess->size() != joints)) return result;
+
+    RingTicket ticket;
+    while (!acquire(ticket))
+    {
+        if (!header->solverRunning.load(std::memory_order_relaxed)) return result;
+        std::this_thread::yield();
+    }
+
+    if (guess) std::copy(guess->data(), guess->data() + joints, ticket.guess);
+    submit(ticket, target, tolerance, guess != nullptr, budget);
+    if (!waitFor(ticket)) return result;
+
+    result.status = static_cast<SolveStatus>(ticket.slot->status);
+    result.iterations = ticket.slot->iterations;
+    result.error = ticket.slot->error;
+    solution = Eigen::Map<const Eigen::VectorXd>(ticket.solution, joints);
+    release(ticket);
+    return result;
+}
@@ -0,0 +1,218 @@
+#include "../include/SoftwareRenderer.h"
+#include "../include/MechanismGeometry.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+
+static const std::uint8_t black[3] = { 0, 0, 0 };
+static const std::uint8_t blue[3] = { 0, 0, 255 };
+static const std::uint8_t red[3] = { 255, 0, 0 };
+
+// constructor
+SoftwareRenderer::SoftwareRenderer(int width, int height) : width(width), height(height), pixels(static_cast<size_t>(width) * height * 3, 255) {}
+
+void SoftwareRenderer::clear()
+{
+    std::fill(pixels.begin(), pixels.end(), static_cast<std::uint8_t>(255));
+}
+
+// -1..1 view coordinates to pixel centers, y up like glOrtho
+void SoftwareRenderer::toPixel(float x, float y, float& px, float& py) const
+{
+    px = (x + 1.0f) * 0.5f * width - 0.5f;
+    py = (1.0f - y) * 0.5f * height - 0.5f;
+}
+
+void SoftwareRenderer::setPixel(int px, int py, const std::uint8_t rgb[3])
+{
+    if (px < 0 || py < 0 || px >= width || py >= height) return;
+    std::uint8_t* p = &pixels[(static_cast<size_t>(py) * width + px) * 3];
+    p[0] = rgb[0];
+    p[1] = rgb[1];
+    p[2] = rgb[2];
+}
+
+void SoftwareRenderer::fillSquare(float px, float py, float size, const std::uint8_t rgb[3])
+{
+    int x0 = static_cast<int>(std::lround(px - size / 2)), y0 = static_cast<int>(std::lround(py - size / 2));
+    int n = static_cast<int>(size);
+    for (int y = y0; y < y0 + n; y++)
+    {
+        for (int x = x0; x < x0 + n; x++) setPixel(x, y, rgb);
+    }
+}
+
+// every pixel whose center lies within half the line width of the segment
+void SoftwareRenderer::drawThickLine(float x0, float y0, float x1, float y1, float lineWidth, const std::uint8_t rgb[3])
+{
+    float half = lineWidth / 2;
+    int minX = std::max(0, static_cast<int>(std::floor(std::min(x0, x1) - half)));
+    int maxX = std::min(width - 1, static_cast<int>(std::ceil(std::max(x0, x1) + half)));
+    int minY = std::max(0, static_cast<int>(std::floor(std::min(y0, y1) - half)));
+    int maxY = std::min(height - 1, static_cast<int>(std::ceil(std::max(y0, y1) + half)));
+
+    float dx = x1 - x0, dy = y1 - y0;
+    float lengthSquared = dx * dx + dy * dy;
+
+    for (int y = minY; y <= maxY; y++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            float t = lengthSquared > 0 ? ((x - x0) * dx + (y - y0) * dy) / lengthSquared : 0.0f;
+            t = std::clamp(t, 0.0f, 1.0f);
+            float ex = x0 + t * dx - x, ey = y0 + t * dy - y;
+            if (ex * ex + ey * ey <= half * half) setPixel(x, y, rgb);
+        }
+    }
+}
+
+// 5 pixel black axes with the 0xF0F0 stipple used by the GUI: 4 pixels off, 4 on
+void SoftwareRenderer::drawDottedAxis()
+{
+    float cx, cy;
+    toPixel(0.0f, 0.0f, cx, cy);
+
+    for (int x = 0; x < width; x++)
+    {
+        if (x % 8 < 4) continue;
+        for (int w = -2; w <= 2; w++) setPixel(x, static_cast<int>(std::lround(cy)) + w, black);
+    }
+    for (int y = 0; y < height; y++)
+    {
+        if ((height - 1 - y) % 8 < 4) continue;
+        for (int w = -2; w <= 2; w++) setPixel(static_cast<int>(std::lround(cx)) + w, y, black);
+    }
+}
+
+// blue 5 pixel links and black 15 pixel joints, from the same decimated vertices as the GUI
+void SoftwareRenderer::drawMechanism(const std::vector<float>& linkLengths, const std::vector<float>& jointAngles)
+{
+    float pixelSize = 2.0f / std::min(width, height);
+    buildMechanismVertices(linkLengths, jointAngles, mechanismDrawScale, pixelSize, vertices);
+
+    size_t count = vertices.size() / 2;
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        float x0, y0, x1, y1;
+        toPixel(vertices[2 * i], vertices[2 * i + 1], x0, y0);
+        toPixel(vertices[2 * i + 2], vertices[2 * i + 3], x1, y1);
+        drawThickLine(x0, y0, x1, y1, 5.0f, blue);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        float px, py;
+        toPixel(vertices[2 * i], vertices[2 * i + 1], px, py);
+        fillSquare(px, py, 15.0f, black);
+    }
+}
+
+void SoftwareRenderer::drawDesiredPosition(float x, float y)
+{
+    float px, py;
+    toPixel(x * mechanismDrawScale, y * mechanismDrawScale, px, py);
+    fillSquare(px, py, 15.0f, red);
+}
+
+const std::vector<std::uint8_t>& SoftwareRenderer::data() const
+{
+    return pixels;
+}
+
+bool SoftwareRenderer::writePPM(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    return static_cast<bool>(file);
+}
+
+// png helpers: crc32 over chunk type and data, adler32 over the zlib payload
+static std::uint32_t crc32(const std::uint8_t* data, size_t length, std::uint32_t crc = 0)
+{
+    static const std::array<std::uint32_t, 256> table = [] { // built once, thread safe
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t n = 0; n < 256; n++)
+        {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void appendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    out.push_back(static_cast<std::uint8_t>(value >> 24));
+    out.push_back(static_cast<std::uint8_t>(value >> 16));
+    out.push_back(static_cast<std::uint8_t>(value >> 8));
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<std::uint8_t>& data)
+{
+    std::vector<std::uint8_t> chunk;
+    appendBigEndian(chunk, static_cast<std::uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+}
+
+bool SoftwareRenderer::writePNG(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    static const std::uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    file.write(reinterpret_cast<const char*>(signature), 8);
+
+    std::vector<std::uint8_t> header;
+    appendBigEndian(header, static_cast<std::uint32_t>(width));
+    appendBigEndian(header, static_cast<std::uint32_t>(height));
+    header.insert(header.end(), { 8, 2, 0, 0, 0 }); // 8 bit rgb, no interlace
+    writeChunk(file, "IHDR", header);
+
+    // scanlines with filter type 0, wrapped in stored deflate blocks of at most 65535 bytes
+    std::vector<std::uint8_t> raw;
+    raw.reserve(static_cast<size_t>(height) * (width * 3 + 1));
+    for (int y = 0; y < height; y++)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels.begin() + static_cast<size_t>(y) * width * 3, pixels.begin() + static_cast<size_t>(y + 1) * width * 3);
+    }
+
+    std::vector<std::uint8_t> zlib = { 0x78, 0x01 };
+    std::uint32_t a = 1, b = 0;
+    for (size_t offset = 0; offset < raw.size() || offset == 0; offset += 65535)
+    {
+        size_t length = std::min<size_t>(65535, raw.size() - offset);
+        bool last = offset + length >= raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<std::uint8_t>(length));
+        zlib.push_back(static_cast<std::uint8_t>(length >> 8));
+        zlib.push_back(static_cast<std::uint8_t>(~length));
+        zlib.push_back(static_cast<std::uint8_t>(~length >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+
+        for (size_t i = offset; i < offset + length; i++)
+        {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        if (last) break;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+    writeChunk(file, "IDAT", zlib);
+
+    writeChunk(file, "IEND", {});
+    return static_cast<bool>(file);
+}
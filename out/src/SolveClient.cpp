@@ -0,0 +1,144 @@
+#include "../include/SolveClient.h"
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// constructor; not connected
+SolveClient::SolveClient() : fd(-1), nextRequest(1) {}
+
+SolveClient::~SolveClient()
+{
+    close();
+}
+
+bool SolveClient::connect(const std::string& socketPath)
+{
+    close();
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SolveClient::close()
+{
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+bool SolveClient::connected() const
+{
+    return fd >= 0;
+}
+
+bool SolveClient::receive(MessageHeader& header)
+{
+    if (fd < 0) return false;
+    if (!receiveExact(fd, &header, sizeof(header)) || header.magic != solveProtocolMagic || header.payloadBytes > maxPayloadBytes)
+    {
+        close(); // framing is lost
+        return false;
+    }
+
+    payload.resize(header.payloadBytes);
+    if (!receiveExact(fd, payload.data(), payload.size()))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+std::uint32_t SolveClient::loadMechanism(const std::vector<double>& links)
+{
+    MessageHeader header;
+    header.type = static_cast<std::uint16_t>(MessageType::LoadMechanism);
+    header.requestId = nextRequest++;
+    header.payloadBytes = static_cast<std::uint32_t>(links.size() * sizeof(double));
+    if (fd < 0 || !sendMessage(fd, header, links.data(), links.size() * sizeof(double))) return 0;
+
+    MessageHeader reply;
+    if (!receive(reply) || reply.type != static_cast<std::uint16_t>(MessageType::MechanismLoaded)) return 0;
+    return reply.mechanism;
+}
+
+bool SolveClient::solve(std::uint32_t mechanism, Coord2D target, double tolerance, RemoteSolveResult& result, const Eigen::VectorXd* guess)
+{
+    return submitSolve(mechanism, target, tolerance, guess) != 0 && receiveSolve(result);
+}
+
+std::uint32_t SolveClient::submitSolve(std::uint32_t mechanism, Coord2D target, double tolerance, const Eigen::VectorXd* guess)
+{
+    SolveRequest request;
+    request.targetX = target.getX();
+    request.targetY = target.getY();
+    request.tolerance = tolerance;
+    if (guess)
+    {
+        request.flags = solveHasGuess;
+        request.joints = static_cast<std::uint32_t>(guess->size());
+    }
+    const std::size_t guessBytes = guess ? guess->size() * sizeof(double) : 0;
+
+    MessageHeader header;
+    header.type = static_cast<std::uint16_t>(MessageType::Solve);
+    header.requestId = nextRequest++;
+    if (nextRequest == 0) nextRequest = 1; // zero means failure
+    header.mechanism = mechanism;
+    header.payloadBytes = static_cast<std::uint32_t>(sizeof(request) + guessBytes);
+
+    if (fd < 0 || !sendMessage(fd, header, &request, sizeof(request), guess ? guess->data() : nullptr, guessBytes)) return 0;
+    return header.requestId;
+}
+
+bool SolveClient::receiveSolve(RemoteSolveResult& result)
+{
+    MessageHeader header;
+    if (!receive(header)) return false;
+
+    result.requestId = header.requestId;
+    result.failure = ServiceError::None;
+    if (header.type == static_cast<std::uint16_t>(MessageType::Error))
+    {
+        result.failure = static_cast<ServiceError>(header.status);
+        result.solution.resize(0);
+        return true;
+    }
+
+    SolveReplyBody body;
+    if (header.type != static_cast<std::uint16_t>(MessageType::SolveReply) || payload.size() < sizeof(body)) return false;
+    std::memcpy(&body, payload.data(), sizeof(body));
+    if (payload.size() != sizeof(body) + body.joints * sizeof(double)) return false;
+
+    result.status = static_cast<SolveStatus>(body.status);
+    result.iterations = body.iterations;
+    result.error = body.error;
+    result.batchSize = static_cast<int>(body.batchSize);
+    result.solution.resize(body.joints);
+    std::memcpy(result.solution.data(), payload.data() + sizeof(body), body.joints * sizeof(double));
+    return true;
+}
+
+bool SolveClient::stats(ServiceStats& current)
+{
+    MessageHeader header;
+    header.type = static_cast<std::uint16_t>(MessageType::Stats);
+    header.requestId = nextRequest++;
+    if (fd < 0 || !sendMessage(fd, header)) return false;
+
+    MessageHeader reply;
+    if (!receive(reply) || reply.type != static_cast<std::uint16_t>(MessageType::StatsReply) || payload.size() != sizeof(current)) return false;
+    std::memcpy(&current, payload.data(), sizeof(current));
+    return true;
+}
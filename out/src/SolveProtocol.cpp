@@ -0,0 +1,58 @@
+#include "../include/SolveProtocol.h"
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+bool sendMessage(int fd, const MessageHeader& header, const void* body, std::size_t bodyBytes, const void* tail, std::size_t tailBytes)
+{
+    iovec parts[3] = {
+        { const_cast<MessageHeader*>(&header), sizeof(header) },
+        { const_cast<void*>(body), bodyBytes },
+        { const_cast<void*>(tail), tailBytes }
+    };
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = 3;
+
+    while (message.msg_iovlen > 0)
+    {
+        ssize_t sent = sendmsg(fd, &message, MSG_NOSIGNAL); // a closed peer must not raise SIGPIPE in the daemon
+        if (sent < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        // skip what went out; a partial send can end inside any part
+        while (message.msg_iovlen > 0 && static_cast<std::size_t>(sent) >= message.msg_iov->iov_len)
+        {
+            sent -= message.msg_iov->iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+        if (message.msg_iovlen > 0)
+        {
+            message.msg_iov->iov_base = static_cast<char*>(message.msg_iov->iov_base) + sent;
+            message.msg_iov->iov_len -= sent;
+        }
+    }
+    return true;
+}
+
+bool receiveExact(int fd, void* data, std::size_t bytes)
+{
+    char* out = static_cast<char*>(data);
+    while (bytes > 0)
+    {
+        ssize_t received = recv(fd, out, bytes, 0);
+        if (received == 0) return false;
+        if (received < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        out += received;
+        bytes -= received;
+    }
+    return true;
+}
@@ -0,0 +1,586 @@
+#include "../include/SolveServer.h"
+#include "../include/InitialGuess.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const std::size_t latencyWindow = 4096; // solves the latency percentiles are taken over
+static const std::size_t readChunk = 64 * 1024;
+
+static std::int64_t nowNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void wake(int fd)
+{
+    char byte = 0;
+    while (write(fd, &byte, 1) < 0 && errno == EINTR) {} // a full pipe already has a wake-up pending
+}
+
+struct SolveServer::Connection
+{
+    int fd;                     // non-blocking
+    int wakeFd;                 // the io thread's wake pipe
+    std::size_t backlogLimit;
+    std::mutex outputMutex;     // the io thread and the dispatcher both reply
+    std::vector<char> output;   // replies the socket has not taken yet, from outputStart on
+    std::size_t outputStart = 0;
+    bool dropped = false;       // over its backlog or gone; replies are discarded from then on
+    std::vector<char> input;    // bytes received but not yet parsed into messages
+
+    Connection(int socket, int wakePipe, std::size_t maxBacklog) : fd(socket), wakeFd(wakePipe), backlogLimit(maxBacklog) {}
+    ~Connection() { ::close(fd); } // the last queued solve holding the connection closes it
+
+    // queues the message and sends what the socket takes right away; the rest goes out from the io thread on POLLOUT
+    bool reply(const MessageHeader& header, const void* body = nullptr, std::size_t bodyBytes = 0, const void* tail = nullptr, std::size_t tailBytes = 0)
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (dropped) return false;
+
+        const bool idle = outputStart == output.size();
+        const char* parts[3] = { reinterpret_cast<const char*>(&header), static_cast<const char*>(body), static_cast<const char*>(tail) };
+        const std::size_t sizes[3] = { sizeof(header), bodyBytes, tailBytes };
+        for (int i = 0; i < 3; i++) output.insert(output.end(), parts[i], parts[i] + sizes[i]);
+        if (!idle) return checkBacklog();
+
+        flush();
+        if (dropped) return false;
+        if (outputStart == output.size()) return true;
+        wake(wakeFd); // the io thread has to start watching for POLLOUT
+        return checkBacklog();
+    }
+
+    // sends queued bytes until the socket would block; call with outputMutex held
+    void flush()
+    {
+        while (!dropped && outputStart < output.size())
+        {
+            ssize_t sent = send(fd, output.data() + outputStart, output.size() - outputStart, MSG_NOSIGNAL); // no SIGPIPE from a closed peer
+            if (sent >= 0) outputStart += sent;
+            else if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            else if (errno != EINTR) drop();
+        }
+
+        if (outputStart == output.size())
+        {
+            output.clear();
+            outputStart = 0;
+        }
+        else if (outputStart > output.size() / 2)
+        {
+            output.erase(output.begin(), output.begin() + outputStart);
+            outputStart = 0;
+        }
+    }
+
+    bool checkBacklog()
+    {
+        if (output.size() - outputStart <= backlogLimit) return true;
+        drop();
+        shutdown(fd, SHUT_RDWR); // the io thread sees the hang-up and lets the connection go
+        wake(wakeFd);
+        return false;
+    }
+
+    void drop()
+    {
+        dropped = true;
+        output.clear();
+        output.shrink_to_fit();
+        outputStart = 0;
+    }
+
+    bool pendingOutput()
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        return outputStart < output.size();
+    }
+
+    bool isDropped()
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        return dropped;
+    }
+
+    void replyError(const MessageHeader& request, ServiceError error)
+    {
+        MessageHeader header;
+        header.type = static_cast<std::uint16_t>(MessageType::Error);
+        header.status = static_cast<std::uint16_t>(error);
+        header.requestId = request.requestId;
+        header.mechanism = request.mechanism;
+        reply(header);
+    }
+};
+
+struct SolveServer::PendingSolve
+{
+    std::shared_ptr<Connection> connection;
+    std::uint32_t requestId = 0;
+    SolveRequest request;
+    Eigen::VectorXd guess;      // empty when the daemon seeds the solve
+    std::int64_t received = 0;  // steady clock nanoseconds
+};
+
+struct SolveServer::Mechanism
+{
+    std::uint32_t id;
+    std::shared_ptr<const CompiledMechanism> compiled; // read by every pool thread at once
+    std::vector<PendingSolve> queue; // guarded by queueMutex
+
+    Mechanism(std::uint32_t mechanismId, const std::vector<double>& links) : id(mechanismId), compiled(CompiledMechanism::compile(links)) {}
+};
+
+// constructor; nothing is bound until start()
+SolveServer::SolveServer(const ServerConfig& serverConfig)
+    : config(serverConfig), pool(serverConfig.threads), listenFd(-1), wakePipe{ -1, -1 }, queueDepth(0), stopping(false),
+      latencyNext(0), connectionCount(0)
+{
+    latencies.reserve(latencyWindow);
+}
+
+SolveServer::~SolveServer()
+{
+    stop();
+}
+
+bool SolveServer::start()
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (config.socketPath.empty() || config.socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path must be between 1 and " << sizeof(address.sun_path) - 1 << " characters.\n";
+        return false;
+    }
+    std::memcpy(address.sun_path, config.socketPath.c_str(), config.socketPath.size());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+    {
+        std::cerr << "Could not create the service socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    // a socket file nobody answers on is left over from a daemon that died; one that answers belongs to a running daemon
+    if (connect(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+    {
+        std::cerr << "Another daemon is already serving " << config.socketPath << ".\n";
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    ::close(listenFd);
+
+    struct stat existing;
+    if (stat(config.socketPath.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            std::cerr << config.socketPath << " exists and is not a socket.\n";
+            listenFd = -1;
+            return false;
+        }
+        unlink(config.socketPath.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0 || pipe2(wakePipe, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        std::cerr << "Could not listen on " << config.socketPath << ": " << std::strerror(errno) << "\n";
+        if (listenFd >= 0) ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    stopping = false;
+    ioThread = std::thread(&SolveServer::ioLoop, this);
+    dispatcherThread = std::thread(&SolveServer::dispatchLoop, this);
+    return true;
+}
+
+void SolveServer::stop()
+{
+    if (!ioThread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queued.notify_one();
+    wake(wakePipe[1]);
+
+    ioThread.join();
+    dispatcherThread.join();
+
+    ::close(listenFd);
+    ::close(wakePipe[0]);
+    ::close(wakePipe[1]);
+    listenFd = wakePipe[0] = wakePipe[1] = -1;
+    unlink(config.socketPath.c_str());
+
+    std::lock_guard<std::mutex> lock(queueMutex); // drop queued solves, and with them the last references to their connections
+    for (std::unique_ptr<Mechanism>& mechanism : mechanisms) mechanism->queue.clear();
+    queueDepth = 0;
+}
+
+// accepts connections and turns their bytes into messages; solves are only queued here, everything else is answered inline
+void SolveServer::ioLoop()
+{
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::vector<pollfd> watched;
+
+    while (true)
+    {
+        watched.clear();
+        watched.push_back({ wakePipe[0], POLLIN, 0 });
+        watched.push_back({ listenFd, POLLIN, 0 });
+        for (const std::shared_ptr<Connection>& connection : connections)
+        {
+            watched.push_back({ connection->fd, static_cast<short>(POLLIN | (connection->pendingOutput() ? POLLOUT : 0)), 0 });
+        }
+
+        if (poll(watched.data(), watched.size(), -1) < 0)
+        {
+            if (errno == EINTR) continue;
+            std::cerr << "Service poll failed: " << std::strerror(errno) << "\n";
+            return;
+        }
+
+        if (watched[0].revents)
+        {
+            char drained[64];
+            while (read(wakePipe[0], drained, sizeof(drained)) > 0) {}
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping) return;
+        }
+
+        // connections first, so the indices in watched still line up with connections
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < connections.size(); i++)
+        {
+            Connection& connection = *connections[i];
+            const short events = watched[i + 2].revents;
+            if (events & POLLOUT)
+            {
+                std::lock_guard<std::mutex> lock(connection.outputMutex);
+                connection.flush();
+            }
+
+            // dropped connections stay alive until their queued solves are answered, and those replies are discarded
+            if (((events & ~POLLOUT) && !handleInput(connections[i])) || connection.isDropped())
+            {
+                std::lock_guard<std::mutex> lock(connection.outputMutex);
+                connection.drop();
+                continue;
+            }
+            connections[kept++] = std::move(connections[i]);
+        }
+        connections.resize(kept);
+
+        if (watched[1].revents & POLLIN)
+        {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (fd >= 0) connections.push_back(std::make_shared<Connection>(fd, wakePipe[1], config.maxReplyBacklog));
+        }
+
+        connectionCount.store(static_cast<std::uint32_t>(connections.size()), std::memory_order_relaxed);
+    }
+}
+
+bool SolveServer::handleInput(const std::shared_ptr<Connection>& connection)
+{
+    std::vector<char>& input = connection->input;
+    const std::size_t old = input.size();
+    input.resize(old + readChunk);
+
+    ssize_t received = recv(connection->fd, input.data() + old, readChunk, 0);
+    if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) received = 0;
+    else if (received <= 0) return false; // closed or broken
+    input.resize(old + received);
+
+    std::size_t consumed = 0;
+    while (input.size() - consumed >= sizeof(MessageHeader))
+    {
+        MessageHeader header;
+        std::memcpy(&header, input.data() + consumed, sizeof(header));
+        if (header.magic != solveProtocolMagic || header.payloadBytes > maxPayloadBytes) return false; // not our protocol; framing is lost
+
+        const std::size_t frame = sizeof(header) + header.payloadBytes;
+        if (input.size() - consumed < frame) break;
+
+        handleMessage(connection, header, input.data() + consumed + sizeof(header));
+        consumed += frame;
+    }
+
+    input.erase(input.begin(), input.begin() + consumed);
+    return true;
+}
+
+void SolveServer::handleMessage(const std::shared_ptr<Connection>& connection, const MessageHeader& header, const char* payload)
+{
+    switch (static_cast<MessageType>(header.type))
+    {
+        case MessageType::LoadMechanism:
+        {
+            const int count = static_cast<int>(header.payloadBytes / sizeof(double));
+            if (count == 0 || header.payloadBytes % sizeof(double) != 0)
+            {
+                connection->replyError(header, ServiceError::BadRequest);
+                return;
+            }
+
+            std::vector<double> links(count);
+            std::memcpy(links.data(), payload, header.payloadBytes);
+            if (!std::all_of(links.begin(), links.end(), [](double length) { return std::isfinite(length) && length > 0.0; }))
+            {
+                connection->replyError(header, ServiceError::BadRequest);
+                return;
+            }
+
+            MessageHeader loaded;
+            loaded.type = static_cast<std::uint16_t>(MessageType::MechanismLoaded);
+            loaded.requestId = header.requestId;
+            loaded.mechanism = loadMechanism(links.data(), count);
+            if (loaded.mechanism == 0) connection->replyError(header, ServiceError::TooManyMechanisms);
+            else connection->reply(loaded);
+            return;
+        }
+
+        case MessageType::Solve:
+        {
+            Mechanism* mechanism = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mechanismMutex);
+                if (header.mechanism >= 1 && header.mechanism <= mechanisms.size()) mechanism = mechanisms[header.mechanism - 1].get();
+            }
+            if (!mechanism)
+            {
+                connection->replyError(header, ServiceError::UnknownMechanism);
+                return;
+            }
+
+            PendingSolve solve;
+            if (header.payloadBytes < sizeof(SolveRequest))
+            {
+                connection->replyError(header, ServiceError::BadRequest);
+                return;
+            }
+            std::memcpy(&solve.request, payload, sizeof(SolveRequest));
+
+            const bool hasGuess = solve.request.flags & solveHasGuess;
+            const int joints = mechanism->compiled->getJoints();
+            const std::size_t expected = sizeof(SolveRequest) + (hasGuess ? joints * sizeof(double) : 0);
+            if (header.payloadBytes != expected || (hasGuess && solve.request.joints != static_cast<std::uint32_t>(joints)))
+            {
+                connection->replyError(header, ServiceError::BadRequest);
+                return;
+            }
+
+            if (hasGuess)
+            {
+                solve.guess.resize(joints);
+                std::memcpy(solve.guess.data(), payload + sizeof(SolveRequest), joints * sizeof(double));
+            }
+            solve.connection = connection;
+            solve.requestId = header.requestId;
+            solve.received = nowNanoseconds();
+
+            int depth;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                mechanism->queue.push_back(std::move(solve));
+                depth = ++queueDepth;
+            }
+            queued.notify_one();
+
+            std::lock_guard<std::mutex> lock(statsMutex);
+            counters.maxQueueDepth = std::max(counters.maxQueueDepth, static_cast<std::uint32_t>(depth));
+            return;
+        }
+
+        case MessageType::Stats:
+        {
+            ServiceStats current = stats();
+            MessageHeader reply;
+            reply.type = static_cast<std::uint16_t>(MessageType::StatsReply);
+            reply.requestId = header.requestId;
+            reply.payloadBytes = sizeof(current);
+            connection->reply(reply, &current, sizeof(current));
+            return;
+        }
+
+        default:
+            connection->replyError(header, ServiceError::UnknownMessage);
+            return;
+    }
+}
+
+// returns the id of the mechanism with exactly these link lengths, loading it on first use; zero once maxMechanisms are loaded
+std::uint32_t SolveServer::loadMechanism(const double* links, int count)
+{
+    auto candidate = std::make_unique<Mechanism>(0, std::vector<double>(links, links + count));
+    const std::uint64_t fingerprint = candidate->compiled->getFingerprint();
+
+    std::lock_guard<std::mutex> lock(mechanismMutex);
+    auto [first, last] = mechanismIds.equal_range(fingerprint);
+    for (auto found = first; found != last; ++found)
+    {
+        if (mechanisms[found->second - 1]->compiled->sameLinks(*candidate->compiled)) return found->second;
+    }
+
+    if (mechanisms.size() >= static_cast<std::size_t>(std::max(config.maxMechanisms, 0))) return 0;
+    candidate->id = static_cast<std::uint32_t>(mechanisms.size() + 1);
+    mechanismIds.emplace(fingerprint, candidate->id);
+    mechanisms.push_back(std::move(candidate));
+    return mechanisms.back()->id;
+}
+
+// waits for queued solves and runs them one mechanism batch at a time; while a batch runs, new requests pile up behind it
+// and form the next one, so batches grow with the load without any tuning
+void SolveServer::dispatchLoop()
+{
+    std::vector<Mechanism*> snapshot;
+    std::vector<PendingSolve> batch;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queued.wait(lock, [this] { return stopping || queueDepth > 0; });
+            if (stopping) return;
+        }
+
+        if (config.coalesceMicroseconds > 0) std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(config.coalesceMicroseconds));
+
+        {
+            std::lock_guard<std::mutex> lock(mechanismMutex);
+            snapshot.clear();
+            for (const std::unique_ptr<Mechanism>& mechanism : mechanisms) snapshot.push_back(mechanism.get());
+        }
+
+        for (Mechanism* mechanism : snapshot)
+        {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                if (mechanism->queue.empty()) continue;
+
+                const std::size_t take = std::min(mechanism->queue.size(), static_cast<std::size_t>(std::max(config.maxBatch, 1)));
+                batch.assign(std::make_move_iterator(mechanism->queue.begin()), std::make_move_iterator(mechanism->queue.begin() + take));
+                mechanism->queue.erase(mechanism->queue.begin(), mechanism->queue.begin() + take);
+                queueDepth -= static_cast<int>(take);
+            }
+
+            solveBatch(*mechanism, batch);
+            batch.clear();
+        }
+    }
+}
+
+// one chunk per pool thread, each with its own solver; replies go out as soon as each solve finishes
+void SolveServer::solveBatch(Mechanism& mechanism, std::vector<PendingSolve>& batch)
+{
+    const int count = static_cast<int>(batch.size());
+    const int workers = static_cast<int>(std::max(pool.size(), 1u));
+    std::atomic<std::uint64_t> failures(0);
+    const CompiledMechanism& compiled = *mechanism.compiled;
+    const MechanismModel& model = compiled.getModel();
+
+    pool.parallelFor(0, count, (count + workers - 1) / workers, [&](int first, int last) {
+        IterativeSolver solver;
+        solver.setVerbose(false);
+        solver.setStepControl(config.stepControl);
+        solver.setJacobianReuse(config.jacobianReuse);
+        solver.setTermination(config.termination);
+
+        for (int i = first; i < last; i++)
+        {
+            PendingSolve& pending = batch[i];
+            if (pending.connection->isDropped()) continue; // nobody left to read the answer
+            Coord2D target(pending.request.targetX, pending.request.targetY);
+            Eigen::VectorXd seed = pending.guess.size() ? pending.guess : optimizeInitialGuess(&model, target);
+
+            SolveResult result;
+            if (compiled.isReachable(target)) result = solver.newtonSolve(&model, seed, target, pending.request.tolerance, 1e-6);
+            else
+            {
+                result.status = SolveStatus::Unreachable;
+                result.solution = std::move(seed);
+            }
+            if (!result.converged()) failures.fetch_add(1, std::memory_order_relaxed);
+
+            SolveReplyBody body;
+            body.status = static_cast<std::int32_t>(result.status);
+            body.iterations = result.iterations;
+            body.error = result.error;
+            body.batchSize = static_cast<std::uint32_t>(count);
+            body.joints = static_cast<std::uint32_t>(result.solution.size());
+
+            MessageHeader header;
+            header.type = static_cast<std::uint16_t>(MessageType::SolveReply);
+            header.requestId = pending.requestId;
+            header.mechanism = mechanism.id;
+            header.payloadBytes = static_cast<std::uint32_t>(sizeof(body) + result.solution.size() * sizeof(double));
+            pending.connection->reply(header, &body, sizeof(body), result.solution.data(), result.solution.size() * sizeof(double));
+
+            recordLatency((nowNanoseconds() - pending.received) * 1e-3);
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    counters.requests += count;
+    counters.batches++;
+    counters.failures += failures.load();
+    counters.maxBatch = std::max(counters.maxBatch, static_cast<std::uint32_t>(count));
+}
+
+void SolveServer::recordLatency(double microseconds)
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    if (latencies.size() < latencyWindow) latencies.push_back(microseconds);
+    else latencies[latencyNext] = microseconds;
+    latencyNext = (latencyNext + 1) % latencyWindow;
+}
+
+ServiceStats SolveServer::stats() const
+{
+    ServiceStats current;
+    std::vector<double> window;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        current = counters;
+        window = latencies;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        current.queueDepth = static_cast<std::uint32_t>(queueDepth);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mechanismMutex);
+        current.mechanisms = static_cast<std::uint32_t>(mechanisms.size());
+    }
+    current.connections = connectionCount.load(std::memory_order_relaxed);
+    current.meanBatch = current.batches ? static_cast<double>(current.requests) / current.batches : 0.0;
+
+    current.latencySamples = static_cast<std::uint32_t>(window.size());
+    if (!window.empty())
+    {
+        std::sort(window.begin(), window.end());
+        auto percentile = [&](double p) { return window[static_cast<std::size_t>(p * (window.size() - 1))]; };
+        current.latencyP50 = percentile(0.50);
+        current.latencyP90 = percentile(0.90);
+        current.latencyP99 = percentile(0.99);
+        current.latencyMax = window.back();
+    }
+    return current;
+}
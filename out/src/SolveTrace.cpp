@@ -0,0 +1,133 @@
+#include "../include/SolveTrace.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+static const char traceMagic[8] = { 'I', 'K', 'T', 'R', 'A', 'C', 'E', '1' };
+
+// constructor
+SolveTrace::SolveTrace() : joints(0) {}
+
+void SolveTrace::reset(int jointCount, int expectedIterations)
+{
+    joints = jointCount;
+    angles.clear();
+    errorNorms.clear();
+    stepNorms.clear();
+
+    angles.reserve(static_cast<std::size_t>(jointCount) * expectedIterations);
+    errorNorms.reserve(expectedIterations);
+    stepNorms.reserve(expectedIterations);
+}
+
+void SolveTrace::record(const Eigen::VectorXd& iterate, double errorNorm, double stepNorm)
+{
+    angles.insert(angles.end(), iterate.data(), iterate.data() + joints);
+    errorNorms.push_back(errorNorm);
+    stepNorms.push_back(stepNorm);
+}
+
+bool SolveTrace::empty() const
+{
+    return errorNorms.empty();
+}
+
+int SolveTrace::getJoints() const
+{
+    return joints;
+}
+
+int SolveTrace::getIterations() const
+{
+    return static_cast<int>(errorNorms.size());
+}
+
+Eigen::Map<const Eigen::MatrixXd> SolveTrace::jointAngles() const
+{
+    return Eigen::Map<const Eigen::MatrixXd>(angles.data(), joints, getIterations());
+}
+
+Eigen::Map<const Eigen::VectorXd> SolveTrace::iterate(int iteration) const
+{
+    return Eigen::Map<const Eigen::VectorXd>(angles.data() + static_cast<std::size_t>(iteration) * joints, joints);
+}
+
+const std::vector<double>& SolveTrace::getErrorNorms() const
+{
+    return errorNorms;
+}
+
+const std::vector<double>& SolveTrace::getStepNorms() const
+{
+    return stepNorms;
+}
+
+bool SolveTrace::writeCSV(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file.precision(17);
+    file << "iteration,error_norm,step_norm";
+    for (int j = 0; j < joints; j++) file << ",q" << j;
+    file << "\n";
+
+    for (int i = 0; i < getIterations(); i++)
+    {
+        file << i << "," << errorNorms[i] << "," << stepNorms[i];
+        const double* column = angles.data() + static_cast<std::size_t>(i) * joints;
+        for (int j = 0; j < joints; j++) file << "," << column[j];
+        file << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool SolveTrace::writeBinary(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    // the payload is written in host order; every platform this builds for is little-endian
+    const std::int32_t header[2] = { joints, getIterations() };
+    file.write(traceMagic, sizeof(traceMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(angles.data()), angles.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(errorNorms.data()), errorNorms.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(stepNorms.data()), stepNorms.size() * sizeof(double));
+
+    return static_cast<bool>(file);
+}
+
+bool SolveTrace::readBinary(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(traceMagic)];
+    std::int32_t header[2];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, traceMagic, sizeof(magic)) != 0) return false;
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] < 0 || header[1] < 0) return false;
+
+    // the rest of the file must be exactly what the header describes, so a corrupt header cannot size the buffers
+    const std::streampos body = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::uint64_t available = static_cast<std::uint64_t>(file.tellg() - body);
+    file.seekg(body);
+    const std::uint64_t values = (static_cast<std::uint64_t>(header[0]) + 2) * static_cast<std::uint64_t>(header[1]);
+    if (!file || available != values * sizeof(double)) return false;
+
+    reset(header[0]);
+    angles.resize(static_cast<std::size_t>(header[0]) * header[1]);
+    errorNorms.resize(header[1]);
+    stepNorms.resize(header[1]);
+
+    file.read(reinterpret_cast<char*>(angles.data()), angles.size() * sizeof(double));
+    file.read(reinterpret_cast<char*>(errorNorms.data()), errorNorms.size() * sizeof(double));
+    file.read(reinterpret_cast<char*>(stepNorms.data()), stepNorms.size() * sizeof(double));
+
+    if (!file)
+    {
+        reset(0);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#include "../include/SolverWorker.h"
+#include "../include/InitialGuess.h"
+
+// constructor; publishes the initial configuration so the render loop has a state before the first solve
+SolverWorker::SolverWorker(const std::vector<double>& linkLengths, const Eigen::VectorXd& initialAngles, std::function<void()> publishCallback)
+    : mechanism(linkLengths), current(initialAngles), reseed(false), targetVersion(0), stopping(false), onPublish(std::move(publishCallback))
+{
+    solver.setVerbose(false);
+
+    SolverState& initial = states.writeSlot();
+    initial.jointAngles.assign(initialAngles.data(), initialAngles.data() + initialAngles.size());
+    states.publish();
+
+    thread = std::thread(&SolverWorker::run, this);
+}
+
+// destructor; wakes the worker so it can exit
+SolverWorker::~SolverWorker()
+{
+    stopping.store(true);
+    targetVersion.fetch_add(1);
+    targetVersion.notify_one();
+    thread.join();
+}
+
+void SolverWorker::setTarget(double x, double y)
+{
+    targets.writeSlot() = { x, y };
+    targets.publish();
+    targetVersion.fetch_add(1, std::memory_order_release);
+    targetVersion.notify_one();
+}
+
+bool SolverWorker::poll()
+{
+    return states.update();
+}
+
+const SolverState& SolverWorker::latest() const
+{
+    return states.readSlot();
+}
+
+// waits for a target, solves from the previous solution and publishes the result
+// targets that arrive during a solve are coalesced; only the newest one is solved next
+void SolverWorker::run()
+{
+    unsigned seen = 0;
+
+    while (true)
+    {
+        targetVersion.wait(seen, std::memory_order_acquire);
+        if (stopping.load()) return;
+        seen = targetVersion.load(std::memory_order_acquire);
+
+        if (!targets.update()) continue;
+        std::array<double, 2> target = targets.readSlot();
+        Coord2D desiredPoint(target[0], target[1]);
+
+        SolverState& state = states.writeSlot();
+        state.target = target;
+        state.reachable = !mechanism.isOutOfReach(desiredPoint);
+        state.converged = false;
+
+        if (state.reachable)
+        {
+            // track from the previous solution; after a failure restart from the quadrant seed instead
+            Eigen::VectorXd seed = reseed ? optimizeInitialGuess(&mechanism, desiredPoint) : current;
+            SolveResult result = solver.newtonSolve(&mechanism, seed, desiredPoint, 1e-6, 1e-6);
+            state.converged = result.converged();
+
+            if (state.converged) current = result.solution;
+            reseed = !state.converged;
+        }
+
+        state.jointAngles.assign(current.data(), current.data() + current.size()); // the last good configuration is always shown
+        states.publish();
+        if (onPublish) onPublish();
+    }
+}
@@ -0,0 +1,125 @@
+#include "../include/SolverWorkspace.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+// constructor; allocates and faults in every buffer
+SolverWorkspace::SolverWorkspace(int jointCount) : joints(0), locked(false)
+{
+    resize(jointCount);
+}
+
+SolverWorkspace::~SolverWorkspace()
+{
+    unlockMemory();
+}
+
+int SolverWorkspace::getJoints() const
+{
+    return joints;
+}
+
+void SolverWorkspace::resize(int jointCount)
+{
+    bool relock = locked;
+    unlockMemory();
+
+    joints = jointCount;
+    J.resize(2, joints);
+    iterate.resize(joints);
+    best.resize(joints);
+    increment.resize(joints);
+    prefault();
+
+    if (relock) lockMemory();
+}
+
+// writing every element forces the allocator's lazily mapped pages to be backed now rather than on first use
+void SolverWorkspace::prefault()
+{
+    J.setZero();
+    iterate.setZero();
+    best.setZero();
+    increment.setZero();
+}
+
+// locks a single buffer; empty buffers trivially succeed
+static bool lockRegion(void* data, std::size_t bytes)
+{
+    if (bytes == 0) return true;
+#ifdef _WIN32
+    return VirtualLock(data, bytes) != 0;
+#else
+    return mlock(data, bytes) == 0;
+#endif
+}
+
+static void unlockRegion(void* data, std::size_t bytes)
+{
+    if (bytes == 0) return;
+#ifdef _WIN32
+    VirtualUnlock(data, bytes);
+#else
+    munlock(data, bytes);
+#endif
+}
+
+bool SolverWorkspace::lockMemory()
+{
+    if (locked) return true;
+
+    const std::size_t vectorBytes = sizeof(double) * static_cast<std::size_t>(joints);
+    locked = lockRegion(J.data(), 2 * vectorBytes)
+        && lockRegion(iterate.data(), vectorBytes)
+        && lockRegion(best.data(), vectorBytes)
+        && lockRegion(increment.data(), vectorBytes);
+
+    if (!locked) // partial success would leave some buffers pinned forever; undo it
+    {
+        locked = true;
+        unlockMemory();
+    }
+    return locked;
+}
+
+void SolverWorkspace::unlockMemory()
+{
+    if (!locked) return;
+
+    const std::size_t vectorBytes = sizeof(double) * static_cast<std::size_t>(joints);
+    unlockRegion(J.data(), 2 * vectorBytes);
+    unlockRegion(iterate.data(), vectorBytes);
+    unlockRegion(best.data(), vectorBytes);
+    unlockRegion(increment.data(), vectorBytes);
+    locked = false;
+}
+
+bool SolverWorkspace::isLocked() const
+{
+    return locked;
+}
+
+bool SolverWorkspace::lockAllMemory()
+{
+#ifdef _WIN32
+    return false; // windows has no process wide equivalent; lock individual workspaces instead
+#else
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#endif
+}
+
+static volatile unsigned char stackSink;
+
+void SolverWorkspace::prefaultStack(std::size_t stackBytes)
+{
+    // one page per frame; volatile so the writes survive optimization
+    constexpr std::size_t chunk = 4096;
+    volatile unsigned char page[chunk];
+    for (std::size_t i = 0; i < chunk; i += 64) page[i] = 0;
+
+    if (stackBytes > chunk) prefaultStack(stackBytes - chunk);
+    stackSink = page[0]; // keeps the frame alive across the recursion so it cannot become a tail call
+}
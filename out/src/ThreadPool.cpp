@@ -0,0 +1,140 @@
+#include "../include/ThreadPool.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+// constructor
+ThreadPool::ThreadPool(unsigned threadCount) : pending(0), stopping(false)
+{
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// destructor; finishes queued work before joining the workers
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::size() const
+{
+    return static_cast<unsigned>(workers.size());
+}
+
+// queue a task
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace_back(std::move(task), IK_PROFILE_NOW());
+        pending++;
+    }
+    taskAvailable.notify_one();
+}
+
+// wait for every submitted task
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+// run a chunked loop on the workers and the calling thread, waiting for this loop's chunks only
+// chunks are claimed from a counter shared by the caller and the helper tasks, so the caller keeps working through them instead
+// of blocking: a parallelFor issued from inside a pool task finishes even when every worker is busy, and concurrent loops or
+// unrelated submitted tasks never hold each other up. Helpers that start after the last chunk is claimed return at once
+void ThreadPool::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body)
+{
+    if (grain < 1) grain = 1;
+    if (begin >= end) return;
+
+    struct Loop
+    {
+        const std::function<void(int, int)>* body;
+        long long begin, end, grain;
+        int chunks;
+        std::atomic<int> nextChunk{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+        int done = 0; // guarded by mutex
+
+        // runs one unclaimed chunk; false once all are claimed. body is only touched for a claimed chunk, and the caller waits
+        // for every claimed chunk, so late helpers never see a dangling body
+        bool runChunk()
+        {
+            const int chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunks) return false;
+
+            const long long first = begin + chunk * grain;
+            (*body)(static_cast<int>(first), static_cast<int>(std::min(first + grain, end)));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++done == chunks) finished.notify_all();
+            return true;
+        }
+    };
+
+    auto loop = std::make_shared<Loop>();
+    loop->body = &body;
+    loop->begin = begin;
+    loop->end = end;
+    loop->grain = grain;
+    loop->chunks = static_cast<int>((static_cast<long long>(end) - begin + grain - 1) / grain);
+
+    const int helpers = std::min(loop->chunks - 1, static_cast<int>(workers.size()));
+    for (int i = 0; i < helpers; i++)
+    {
+        submit([loop] { while (loop->runChunk()) {} });
+    }
+
+    while (loop->runChunk()) {}
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&loop] { return loop->done == loop->chunks; });
+}
+
+// each worker pulls tasks until the pool is stopped and the queue is empty
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        [[maybe_unused]] std::int64_t queuedAt;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+
+            task = std::move(tasks.front().first);
+            queuedAt = tasks.front().second;
+            tasks.pop_front();
+        }
+
+        IK_PROFILE_SPAN("queue wait", queuedAt, IK_PROFILE_NOW());
+        {
+            IK_PROFILE_SCOPE("worker task");
+            task();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+            if (pending == 0) allDone.notify_all();
+        }
+    }
+}
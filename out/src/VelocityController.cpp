@@ -0,0 +1,115 @@
+#include "../include/VelocityController.h"
+#include "../include/IterativeSolver.h"
+#include "../include/AllocationTracker.h"
+#include <algorithm>
+#include <limits>
+
+// constructor; every work buffer is allocated here so computeJointVelocities never has to
+VelocityController::VelocityController(const std::vector<double>& linkLengths, double controlPeriod, double dampingFactor, int saturationPasses)
+    : links(linkLengths), dt(controlPeriod), damping(dampingFactor), maxSaturationPasses(saturationPasses)
+{
+    const int n = static_cast<int>(links.size());
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    maxVelocity = Eigen::VectorXd::Constant(n, infinity);
+    lowerPosition = Eigen::VectorXd::Constant(n, -infinity);
+    upperPosition = Eigen::VectorXd::Constant(n, infinity);
+
+    J.resize(2, n);
+    lower.resize(n);
+    upper.resize(n);
+    saturated.resize(n);
+}
+
+bool VelocityController::setVelocityLimits(const Eigen::VectorXd& limits)
+{
+    if (limits.size() != static_cast<Eigen::Index>(links.size())) return false;
+    maxVelocity = limits.cwiseAbs();
+    return true;
+}
+
+bool VelocityController::setPositionLimits(const Eigen::VectorXd& lowerLimits, const Eigen::VectorXd& upperLimits)
+{
+    const Eigen::Index n = static_cast<Eigen::Index>(links.size());
+    if (lowerLimits.size() != n || upperLimits.size() != n) return false;
+    lowerPosition = lowerLimits;
+    upperPosition = upperLimits;
+    return true;
+}
+
+// damped least squares with saturation of the joints that break their bounds
+int VelocityController::computeJointVelocities(const Eigen::Ref<const Eigen::VectorXd>& q, const Eigen::Vector2d& v, Eigen::Ref<Eigen::VectorXd> qdot)
+{
+    IK_NO_ALLOCATION_REGION("velocity controller");
+
+    const int n = static_cast<int>(links.size());
+    if (q.size() != n || qdot.size() != n) return -1;
+    IterativeSolver::jacobianKernel(links.data(), q.data(), n, J.data());
+
+    // the tighter of the velocity limit and what keeps the joint inside its position range over one period
+    for (int i = 0; i < n; i++)
+    {
+        lower[i] = std::max(-maxVelocity[i], (lowerPosition[i] - q[i]) / dt);
+        upper[i] = std::min(maxVelocity[i], (upperPosition[i] - q[i]) / dt);
+        if (lower[i] > upper[i]) lower[i] = upper[i] = (lower[i] + upper[i]) / 2; // already outside the range: head back in
+        saturated[i] = 0;
+    }
+
+    int saturatedCount = 0;
+    for (int pass = 0; ; pass++)
+    {
+        // remaining task after the saturated joints' contribution, and J J^T over the free joints
+        Eigen::Vector2d remaining = v;
+        Eigen::Matrix2d JJt = Eigen::Matrix2d::Identity() * (damping * damping);
+        for (int i = 0; i < n; i++)
+        {
+            Eigen::Vector2d column(J(0, i), J(1, i));
+            if (saturated[i]) remaining -= column * qdot[i];
+            else JJt += column * column.transpose();
+        }
+
+        // a singular J J^T (no damping, stretched arm) falls back to a tiny damping term
+        if (std::abs(JJt.determinant()) < 1e-12) JJt += Eigen::Matrix2d::Identity() * 1e-6;
+        Eigen::Vector2d y = JJt.inverse() * remaining;
+
+        // free joints take J^T y; find the one that overshoots its bound by the most (any overshoot is a candidate,
+        // including a joint outside its range whose bound has the same sign as the velocity)
+        int worst = -1;
+        double worstOvershoot = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            if (saturated[i]) continue;
+            qdot[i] = J(0, i) * y[0] + J(1, i) * y[1];
+
+            double overshoot = std::max(qdot[i] - upper[i], lower[i] - qdot[i]);
+            if (overshoot > worstOvershoot)
+            {
+                worstOvershoot = overshoot;
+                worst = i;
+            }
+        }
+
+        if (worst < 0) break; // every joint inside its bounds
+
+        if (pass + 1 >= maxSaturationPasses)
+        {
+            // out of passes: clip every remaining offender so the output is always feasible and the time is bounded
+            for (int i = 0; i < n; i++)
+            {
+                if (saturated[i]) continue;
+                if (qdot[i] > upper[i] || qdot[i] < lower[i])
+                {
+                    qdot[i] = std::clamp(qdot[i], lower[i], upper[i]);
+                    saturatedCount++;
+                }
+            }
+            break;
+        }
+
+        qdot[worst] = std::clamp(qdot[worst], lower[worst], upper[worst]);
+        saturated[worst] = 1;
+        saturatedCount++;
+    }
+
+    return saturatedCount;
+}
@@ -1,15 +1,12 @@
 #include "../include/gui.h"
+#include "../include/MechanismGeometry.h"
+#include "../include/SolverWorker.h"
+#include "../include/InitialGuess.h"
 
 
 // OpenGL version
 #define GLSL_VERSION "#version 130"
 
-// GUI State Variables
-bool showStartFrame = true;
-//int jointCount = 1;
-//std::vector<float> linkLengths;
-//std::array<float, 2> desiredPosition = { 0.0f, 0.0f };
-std::vector<float> jointAngles; // Initial angles for each joint
 
 GUI::GUI() {
     this->jointCount = 1; // Default number of joints
@@ -17,6 +14,8 @@ GUI::GUI() {
     this->desiredPosition = { 0.0f, 0.0f }; // Default desired position
 }
 
+GUI::~GUI() = default; // SolverWorker is complete here
+
 int GUI::getJoints() {
     return this->jointCount;
 }
@@ -37,96 +36,211 @@ void GUI::CheckOpenGLError(const std::string& label) {
     }
 }
 
+// Size of one pixel in the -1..1 orthographic view; joints closer than this are merged when drawing
+void GUI::UpdatePixelSize(int screenWidth, int screenHeight) {
+    int shortestSide = screenWidth < screenHeight ? screenWidth : screenHeight;
+    pixelSize = shortestSide > 0 ? 2.0f / shortestSide : 0.0f;
+}
+
 // Function to draw the X and Y axis
 void GUI::DrawDottedAxis() {
+    static const GLfloat axisVertices[] = {
+        -1.0f, 0.0f, 1.0f, 0.0f, // X-Axis
+        0.0f, -1.0f, 0.0f, 1.0f  // Y-Axis
+    };
+
     glEnable(GL_LINE_STIPPLE);
     glLineStipple(1, 0xF0F0); // More spaced dots
 
     glLineWidth(5.0f); // Thicker axis lines
-
-    glBegin(GL_LINES);
     glColor3f(0.0f, 0.0f, 0.0f); // Black color for axes
 
-    // X-Axis
-    glVertex2f(-1.0f, 0.0f);
-    glVertex2f(1.0f, 0.0f);
-
-    // Y-Axis
-    glVertex2f(0.0f, -1.0f);
-    glVertex2f(0.0f, 1.0f);
-
-    glEnd();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, axisVertices);
+    glDrawArrays(GL_LINES, 0, 4);
+    glDisableClientState(GL_VERTEX_ARRAY);
 
     glLineWidth(1.0f); // Reset to default
     glDisable(GL_LINE_STIPPLE);
-    glFlush();
 }
 
-// Scale factor: Reduce size by a factor of 7
-#define SCALE_FACTOR (1.0f / 7.0f)
+// Scale factor: Reduce size by a factor of 7 (shared with the headless renderer)
+#define SCALE_FACTOR mechanismDrawScale
 
 // Function to draw the mechanism (now scaled correctly)
+// joint positions are computed once per frame into a vertex array and drawn with one call for the links and one for the joints
 void GUI::DrawMechanism() {
     if (linkLengths.empty()) return;
 
+    buildMechanismVertices(linkLengths, jointAngles, SCALE_FACTOR, pixelSize, mechanismVertices);
+    GLsizei vertexCount = static_cast<GLsizei>(mechanismVertices.size() / 2);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, mechanismVertices.data());
+
     glColor3f(0.0f, 0.0f, 1.0f); // Blue for links
     glLineWidth(5.0f); // Thicker links
+    glDrawArrays(GL_LINE_STRIP, 0, vertexCount);
 
-    float x = 0.0f, y = 0.0f;
-    float angleSum = 0.0f;
+    glColor3f(0.0f, 0.0f, 0.0f); // Black for joints
+    glPointSize(15.0f); // Bigger joint dots
+    glDrawArrays(GL_POINTS, 0, vertexCount);
 
-    glBegin(GL_LINES); // Start drawing all links at once
-    for (int i = 0; i < jointCount; i++) {
-        angleSum += jointAngles[i]; // Accumulate joint angles
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
 
-        // Apply the scaling factor to link lengths
-        float newX = x + (linkLengths[i] * SCALE_FACTOR) * cos(angleSum);
-        float newY = y + (linkLengths[i] * SCALE_FACTOR) * sin(angleSum);
+// Function to draw the desired position (as a red dot)
+void GUI::DrawDesiredPosition() {
+    glColor3f(1.0f, 0.0f, 0.0f); // Red for the desired position
+    glPointSize(15.0f); // Larger for visibility
+
+    glBegin(GL_POINTS);
+    glVertex2f(desiredPosition[0] * SCALE_FACTOR, desiredPosition[1] * SCALE_FACTOR);
+    glEnd();
+}
 
-        glVertex2f(x, y); // Start of the link
-        glVertex2f(newX, newY); // End of the link
 
-        x = newX;
-        y = newY;
+// Solve for the mechanism and target entered in the setup panel, then start replaying the iterations
+bool GUI::Solve() {
+    MechanismModel mechanism;
+    mechanism.initializeMechanism(this);
+    Coord2D desiredPoint = Coord2D::getValidInput(this);
+
+    if (mechanism.isOutOfReach(desiredPoint)) { // farther away than the max reach of the mechanism at full extension
+        status = "No solution exists because the desired point is out of reach of the mechanism.";
+        return false;
     }
-    glEnd(); // Only end once after all links are drawn
 
-    // Draw joints
-    glColor3f(0.0f, 0.0f, 0.0f); // Black for joints
-    glPointSize(15.0f); // Bigger joint dots
+    IterativeSolver solver;
+    SolveResult result = solver.newtonSolve(&mechanism, optimizeInitialGuess(&mechanism, desiredPoint), desiredPoint, 1e-6, 1e-6, true);
 
-    glBegin(GL_POINTS);
-    x = 0.0f;
-    y = 0.0f;
-    angleSum = 0.0f;
+    if (!result.converged()) {
+        status = "Convergence unstable; no solution was found.";
+        return false;
+    }
+    solution = std::move(result.trace);
+
+    // The worker wakes the event loop whenever it publishes a new state
+    worker = std::make_unique<SolverWorker>(mechanism.getLinks(), result.solution, [] { glfwPostEmptyEvent(); });
+
+    status = "Converged after " + std::to_string(solution.getIterations()) + " iterations. Drag with the left mouse button to move the target.";
+    replayStart = glfwGetTime();
+    state = SessionState::Playback;
+    return true;
+}
+
+// While the left mouse button is held the target follows the cursor and is sent to the solver thread
+// returns whether the target moved this frame
+bool GUI::DragTarget(GLFWwindow* window, int screenWidth, int screenHeight) {
+    if (!worker || ImGui::GetIO().WantCaptureMouse) return false;
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS || screenWidth <= 0 || screenHeight <= 0) return false;
+
+    double cursorX, cursorY;
+    glfwGetCursorPos(window, &cursorX, &cursorY);
+
+    // window pixels -> -1..1 view -> mechanism units
+    float x = static_cast<float>((2.0 * cursorX / screenWidth - 1.0) / SCALE_FACTOR);
+    float y = static_cast<float>((1.0 - 2.0 * cursorY / screenHeight) / SCALE_FACTOR);
+    if (x == desiredPosition[0] && y == desiredPosition[1]) return false;
 
-    glVertex2f(x, y); // Draw the base joint at origin
+    desiredPosition = { x, y };
+    worker->setTarget(x, y);
+    return true;
+}
 
-    for (int i = 0; i < jointCount; i++) {
-        angleSum += jointAngles[i];
-        x += (linkLengths[i] * SCALE_FACTOR) * cos(angleSum);
-        y += (linkLengths[i] * SCALE_FACTOR) * sin(angleSum);
+// Replay picks the iterate for the current time instead of sleeping; live mode takes the newest solver state without waiting
+bool GUI::UpdateJointAngles() {
+    if (state == SessionState::Playback) {
+        const double secondsPerIterate = 0.5;
+        size_t index = static_cast<size_t>((glfwGetTime() - replayStart) / secondsPerIterate);
+        if (index >= static_cast<size_t>(solution.getIterations())) {
+            index = solution.getIterations() - 1;
+            state = SessionState::Live;
+        }
 
-        glVertex2f(x, y); // Draw joint at the end of each link
+        Eigen::Map<const Eigen::VectorXd> jointState = solution.iterate(static_cast<int>(index));
+        for (size_t i = 0; i < jointAngles.size() && i < static_cast<size_t>(jointState.size()); i++) {
+            jointAngles[i] = static_cast<float>(jointState[i]);
+        }
+        return state == SessionState::Playback;
     }
-    glEnd(); // End joint drawing
 
-    glFlush(); // Ensure rendering is pushed to GPU
+    if (state == SessionState::Live && worker && worker->poll()) {
+        jointAngles = worker->latest().jointAngles;
+    }
+    return false;
 }
 
-// Function to draw the desired position (as a red dot)
-void GUI::DrawDesiredPosition() {
-    glColor3f(1.0f, 0.0f, 0.0f); // Red for the desired position
-    glPointSize(15.0f); // Larger for visibility
+// Full window form for the mechanism and target
+void GUI::DrawSetupPanel(int screenWidth, int screenHeight) {
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2((float)screenWidth, (float)screenHeight));
 
-    glBegin(GL_POINTS);
-    glVertex2f(desiredPosition[0] * SCALE_FACTOR, desiredPosition[1] * SCALE_FACTOR);
-    glEnd();
-    glFlush();
+    ImGui::Begin("Setup Mechanism", nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
+
+    // Update class member instead of a local variable
+    ImGui::Text("Enter Number of Joints:");
+    ImGui::InputInt("##num_joints", &this->jointCount);
+    if (this->jointCount < 1) this->jointCount = 1;
+
+    // Ensure linkLengths and jointAngles match joint count
+    if (this->linkLengths.size() != static_cast<size_t>(this->jointCount)) {
+        this->linkLengths.resize(this->jointCount, 1.0f);
+    }
+    if (this->jointAngles.size() != static_cast<size_t>(this->jointCount)) {
+        this->jointAngles.resize(this->jointCount, 0.5f);
+    }
+
+    // Input: Link Lengths
+    for (int i = 0; i < this->jointCount; i++) {
+        std::string label = "Link " + std::to_string(i + 1) + " Length";
+        ImGui::InputFloat(label.c_str(), &this->linkLengths[i]); // Update class variable
+    }
+
+    // Desired Position Input (Update class member)
+    ImGui::Text("Desired Position (X, Y):");
+    ImGui::InputFloat2("##desired_position", this->desiredPosition.data());
+
+    // Submit button
+    if (ImGui::Button("Submit", ImVec2(200, 50))) {
+        Solve();
+    }
+
+    if (!status.empty()) ImGui::Text("%s", status.c_str());
+
+    ImGui::End();
 }
 
+// Small overlay shown over the mechanism during playback and live dragging
+void GUI::DrawSessionPanel() {
+    ImGui::SetNextWindowPos(ImVec2(10, 10));
+    ImGui::Begin("Session", nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_AlwaysAutoResize);
+
+    ImGui::Text("%s", status.c_str());
+
+    ImGui::Text("Desired Position (X, Y):");
+    ImGui::InputFloat2("##target", this->desiredPosition.data());
+    if (ImGui::Button("Re-solve", ImVec2(200, 50))) {
+        Solve(); // same mechanism, new target; replays the new iterations
+    }
 
-void GUI::RunGUI() {
+    ImGui::SameLine();
+    if (ImGui::Button("Replay", ImVec2(200, 50)) && !solution.empty()) {
+        replayStart = glfwGetTime();
+        state = SessionState::Playback;
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Edit Mechanism", ImVec2(200, 50))) {
+        state = SessionState::Setup;
+    }
+
+    ImGui::End();
+}
+
+// One window and one GL/ImGui context for the whole session
+// the loop blocks in glfwWaitEvents while nothing changes and only polls while animating or dragging
+void GUI::Run() {
     // Initialize GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW\n";
@@ -163,37 +277,36 @@ void GUI::RunGUI() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(GLSL_VERSION);
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
-    bool countdownStarted = false; // Track whether countdown has started
+    bool animating = false;
+    int settleFrames = 2; // ImGui needs a couple of frames after an input event to settle its layout
 
     // Main loop
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
-
-        // If the initial mechanism is shown, start the countdown
-        if (!showStartFrame && !countdownStarted) {
-            startTime = std::chrono::high_resolution_clock::now(); // Start countdown
-            countdownStarted = true;
+        bool dragging = state != SessionState::Setup && glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+        if (animating || dragging || settleFrames > 0) {
+            glfwPollEvents();
         }
-
-        // If countdown started, check elapsed time
-        if (countdownStarted) {
-            auto currentTime = std::chrono::high_resolution_clock::now();
-            double elapsedSeconds = std::chrono::duration<double>(currentTime - startTime).count();
-            if (elapsedSeconds >= 5.0) { // Exit after 5 seconds
-                break;
-            }
+        else {
+            glfwWaitEvents(); // idle until input, a resize or a solver result arrives
+            settleFrames = 2;
         }
+        if (settleFrames > 0) settleFrames--;
 
         // Update the screen size dynamically
         glfwGetWindowSize(window, &screenWidth, &screenHeight);
+        UpdatePixelSize(screenWidth, screenHeight);
 
         // Clear OpenGL screen
         glViewport(0, 0, screenWidth, screenHeight);
         glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        if (!showStartFrame) {
+        animating = false;
+        if (state != SessionState::Setup) {
+            // Dragging ends the replay and hands the mechanism to the solver thread
+            if (DragTarget(window, screenWidth, screenHeight)) state = SessionState::Live;
+            animating = UpdateJointAngles();
+
             glMatrixMode(GL_PROJECTION);
             glLoadIdentity();
             glOrtho(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0);
@@ -211,42 +324,11 @@ void GUI::RunGUI() {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        if (showStartFrame) {
-            ImGui::SetNextWindowPos(ImVec2(0, 0));
-            ImGui::SetNextWindowSize(ImVec2((float)screenWidth, (float)screenHeight));
-
-            ImGui::Begin("Setup Mechanism", nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize);
-
-            // Update class member instead of a local variable
-            ImGui::Text("Enter Number of Joints:");
-            ImGui::InputInt("##num_joints", &this->jointCount);
-            if (this->jointCount < 1) this->jointCount = 1;
-
-            // Ensure linkLengths and jointAngles match joint count
-            if (this->linkLengths.size() != static_cast<size_t>(this->jointCount)) {
-                this->linkLengths.resize(this->jointCount, 1.0f);
-            }
-            if (jointAngles.size() != static_cast<size_t>(this->jointCount)) {
-                jointAngles.resize(this->jointCount, 0.5f);
-            }
-
-            // Input: Link Lengths
-            for (int i = 0; i < this->jointCount; i++) {
-                std::string label = "Link " + std::to_string(i + 1) + " Length";
-                ImGui::InputFloat(label.c_str(), &this->linkLengths[i]); // Update class variable
-            }
-
-            // Desired Position Input (Update class member)
-            ImGui::Text("Desired Position (X, Y):");
-            ImGui::InputFloat2("##desired_position", this->desiredPosition.data());
-
-
-            // Submit button
-            if (ImGui::Button("Submit", ImVec2(200, 50))) {
-                showStartFrame = false;
-            }
-
-            ImGui::End();
+        if (state == SessionState::Setup) {
+            DrawSetupPanel(screenWidth, screenHeight);
+        }
+        else {
+            DrawSessionPanel();
         }
 
         // Render ImGui
@@ -257,6 +339,8 @@ void GUI::RunGUI() {
         glfwSwapBuffers(window);
     }
 
+    worker.reset(); // stop the solver thread before the context goes away
+
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -264,73 +348,3 @@ void GUI::RunGUI() {
     glfwDestroyWindow(window);
     glfwTerminate();
 }
-
-void GUI::VisualizeSolution(const std::vector<Eigen::VectorXd>& solution)
-{
-    if (solution.empty()) {
-        std::cerr << "Solver returned an empty solution. Cannot visualize." << std::endl;
-        return;
-    }
-
-    // Initialize GLFW
-    if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW\n";
-        return;
-    }
-
-    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
-    int screenWidth = mode->width;
-    int screenHeight = mode->height;
-
-    // Open a GLFW window for visualization
-    GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "IK Solver Visualization", nullptr, nullptr);
-    if (!window) {
-        std::cerr << "Failed to create GLFW window for solution visualization\n";
-        return;
-    }
-
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1); // Enable VSync
-
-    // Keep the same projection from initial visualization
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0); // Ensures same scaling
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-
-    // Loop through each iteration's joint angles and visualize
-    for (const auto& jointState : solution) {
-        // Update joint angles with current iteration values
-        for (size_t i = 0; i < jointAngles.size(); i++) {
-            jointAngles[i] = jointState[i]; // Assign angles from solution
-        }
-
-        // Clear OpenGL screen
-        glViewport(0, 0, screenWidth, screenHeight);
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        // Preserve initial visualization scale & position
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
-
-        // Draw updated visualization
-        DrawDottedAxis();
-        DrawMechanism();
-        DrawDesiredPosition();
-
-        // Swap buffers to display updated frame
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-
-        // Delay for 1 second between iterations
-        std::this_thread::sleep_for(std::chrono::seconds(2));
-
-        // If window is closed, stop visualization early
-        if (glfwWindowShouldClose(window)) break;
-    }
-
-    // Cleanup
-    glfwDestroyWindow(window);
-}
@@ -0,0 +1,123 @@
+// AllocationTest.cpp : the hot paths marked as no-allocation regions really do not allocate, with the profiler recording spans
+//                      inside them. Built against ik_core_checked (IK_TRACK_ALLOCATIONS and IK_ENABLE_PROFILING) with the
+//                      allocation hooks linked in. Builds as the ik_test_allocations target.
+
+#include "../include/AllocationTracker.h"
+#include "../include/CollisionScene.h"
+#include "../include/CompiledMechanism.h"
+#include "../include/IterativeSolver.h"
+#include "../include/Profiler.h"
+#include "../include/VelocityController.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+static int* sink; // keeps the deliberate allocation below from being optimized away
+
+// violations counted while body runs
+template <typename Body>
+static long long violationsDuring(Body body)
+{
+    const long long before = AllocationTracker::snapshot().violations;
+    body();
+    return AllocationTracker::snapshot().violations - before;
+}
+
+// every bounded solve flavour, with every secondary objective switched on
+static void boundedSolves(const std::vector<double>& links, const CollisionScene& scene)
+{
+    const int joints = static_cast<int>(links.size());
+    const MechanismModel model(links);
+    const CompiledMechanism compiled(links);
+    ChainCollider collider(&scene, joints, 0.05);
+
+    SecondaryObjectives objectives;
+    objectives.jointLimitWeight = 0.1;
+    objectives.lowerLimits = Eigen::VectorXd::Constant(joints, -2.0);
+    objectives.upperLimits = Eigen::VectorXd::Constant(joints, 2.0);
+    objectives.restPoseWeight = 0.05;
+    objectives.restPose = Eigen::VectorXd::Zero(joints);
+    objectives.manipulabilityWeight = 0.05;
+    objectives.collisionWeight = 0.5;
+    objectives.collider = &collider;
+
+    IterativeSolver plain, secondary;
+    plain.setVerbose(false);
+    secondary.setVerbose(false);
+    secondary.setSecondaryObjectives(objectives);
+
+    SolverWorkspace workspace(joints);
+    const Eigen::VectorXd guess = Eigen::VectorXd::Constant(joints, 0.2);
+    for (const Coord2D& target : { Coord2D(1.5, 1.2), Coord2D(-2.0, 0.4), Coord2D(9.0, 9.0) })
+    {
+        plain.newtonSolveBounded(&model, guess, target, 1e-10, SolveBudget(), workspace);
+        plain.newtonSolveBounded(compiled, guess, target, 1e-10, SolveBudget(), workspace);
+        secondary.newtonSolveBounded(&model, guess, target, 1e-10, SolveBudget(), workspace);
+    }
+}
+
+int main()
+{
+    AllocationTracker::setAbortOnViolation(false); // count violations so every path below is reported, not just the first
+    Profiler::clear();
+
+    // the hooks are live: an allocation inside a region is caught
+    IK_CHECK(violationsDuring([] {
+        IK_NO_ALLOCATION_REGION("deliberate");
+        sink = new int[100];
+    }) == 1);
+    delete[] sink;
+
+    CollisionScene scene;
+    for (int i = 0; i < 40; i++) scene.addCircle(Eigen::Vector2d(0.3 * i - 6.0, 0.5 * (i % 5) - 1.0), 0.2);
+    scene.addBox(Eigen::Vector2d(0.5, 0.5), Eigen::Vector2d(1.0, 1.5));
+    scene.build();
+    const std::vector<double> links = { 1.0, 0.8, 0.6, 0.5, 0.4, 0.3 };
+
+    // bounded solves on this thread, and on a fresh thread whose first profiled span is inside the solve
+    IK_CHECK(violationsDuring([&] { boundedSolves(links, scene); }) == 0);
+    long long threadViolations = -1;
+    std::thread fresh([&] { threadViolations = violationsDuring([&] { boundedSolves(links, scene); }); });
+    fresh.join();
+    IK_CHECK(threadViolations == 0);
+
+    // the velocity controller, with limits tight enough to saturate joints
+    VelocityController controller(links, 0.01, 0.05);
+    controller.setVelocityLimits(Eigen::VectorXd::Constant(6, 0.5));
+    controller.setPositionLimits(Eigen::VectorXd::Constant(6, -0.4), Eigen::VectorXd::Constant(6, 0.4));
+    Eigen::VectorXd q = Eigen::VectorXd::Constant(6, 0.35), qdot(6);
+    int saturated = 0;
+    IK_CHECK(violationsDuring([&] {
+        for (int i = 0; i < 100; i++) saturated += controller.computeJointVelocities(q, Eigen::Vector2d(20.0, -10.0), qdot);
+    }) == 0);
+    IK_CHECK(saturated > 0);
+
+    // collision detection from joint angles and from a jacobian, against obstacles and the chain itself
+    ChainCollider collider(&scene, 6, 0.05);
+    Eigen::MatrixXd J(2, 6);
+    int contacts = 0;
+    IK_CHECK(violationsDuring([&] {
+        for (int i = 0; i < 100; i++)
+        {
+            const Eigen::VectorXd angles = Eigen::VectorXd::LinSpaced(6, -0.02 * i, 0.04 * i); // the fold tightens into self contact
+            contacts += collider.detect(links, angles);
+            IterativeSolver::jacobianKernel(links.data(), angles.data(), 6, J.data());
+            contacts += collider.detect(J.data(), 6);
+        }
+    }) == 0);
+    IK_CHECK(contacts > 0);
+
+    // the profiler was recording inside the regions all along
+    const std::string path = "/tmp/ik_test_allocations_" + std::to_string(getpid()) + ".json";
+    IK_CHECK(Profiler::writeChromeTrace(path));
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    IK_CHECK(text.str().find("\"bounded newton solve\"") != std::string::npos);
+    std::remove(path.c_str());
+
+    return testResult();
+}
@@ -0,0 +1,64 @@
+// BoundedSolveTest.cpp : every way newtonSolveBounded can end, the time budget it returns within, and the best iterate it
+//                        keeps when the last one is worse. Builds as the ik_test_bounded_solve target.
+
+#include "../include/IterativeSolver.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+
+// error norm of a configuration
+static double errorAt(IterativeSolver& solver, const MechanismModel& model, const Eigen::VectorXd& q, Coord2D target)
+{
+    return (Eigen::Vector2d(target.getX(), target.getY()) - solver.endEffectorPosition(&model, q)).norm();
+}
+
+int main()
+{
+    const MechanismModel model({ 1.0, 0.8, 0.6, 0.4 });
+    IterativeSolver solver;
+    SolverWorkspace workspace(4);
+    const Eigen::VectorXd guess = Eigen::VectorXd::Constant(4, 0.3);
+
+    // converges well inside the default budget, with the answer in best
+    const Coord2D target(1.2, 1.1);
+    BoundedSolveResult result = solver.newtonSolveBounded(&model, guess, target, 1e-10, SolveBudget(), workspace);
+    IK_CHECK(result.status == SolveStatus::Converged && result.error < 1e-10);
+    IK_CHECK_NEAR(errorAt(solver, model, workspace.best, target), result.error, 1e-12);
+
+    // the iteration budget runs out first
+    SolveBudget twoIterations;
+    twoIterations.iterations = 2;
+    result = solver.newtonSolveBounded(&model, guess, target, 1e-10, twoIterations, workspace);
+    IK_CHECK(result.status == SolveStatus::BudgetExhausted && result.iterations == 2 && result.error > 1e-10);
+
+    // beyond the reach the minimum norm steps overshoot and wander: the solve is called diverging, and best keeps the closest
+    // iterate although the last one is much farther off
+    const Coord2D far(4.0, 0.5);
+    result = solver.newtonSolveBounded(&model, guess, far, 1e-10, SolveBudget(), workspace);
+    IK_CHECK(result.status == SolveStatus::Diverging);
+    IK_CHECK(result.iterations >= SolveBudget().divergenceWindow);
+    IK_CHECK_NEAR(errorAt(solver, model, workspace.best, far), result.error, 1e-12);
+    IK_CHECK(errorAt(solver, model, workspace.iterate, far) > result.error);
+
+    // a guess that is not a number ends the solve at once
+    result = solver.newtonSolveBounded(&model, Eigen::VectorXd::Constant(4, std::nan("")), target, 1e-10, SolveBudget(), workspace);
+    IK_CHECK(result.status == SolveStatus::NonFinite && result.iterations == 0);
+
+    // a zero tolerance never converges and the other limits are off, so only the clock ends this solve; it must not start an
+    // iteration it cannot finish, so it returns close to the deadline rather than an iteration past it
+    const int joints = 100000;
+    const MechanismModel chain(std::vector<double>(joints, 1e-5));
+    SolverWorkspace chainWorkspace(joints);
+    SolveBudget deadline;
+    deadline.seconds = 0.05;
+    deadline.iterations = INT_MAX;
+    deadline.divergenceWindow = INT_MAX;
+    const auto start = std::chrono::steady_clock::now();
+    result = solver.newtonSolveBounded(&chain, Eigen::VectorXd::Constant(joints, 1e-4), Coord2D(0.3, 0.4), 0.0, deadline, chainWorkspace);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    IK_CHECK(result.status == SolveStatus::BudgetExhausted && result.iterations > 1);
+    if (!IK_CHECK(elapsed < 2.0 * deadline.seconds)) std::cerr << "  returned after " << elapsed << " s on a " << deadline.seconds << " s budget\n";
+
+    return testResult();
+}
@@ -0,0 +1,101 @@
+// CollisionSceneTest.cpp : the spatial hash finds the same contacts as testing every obstacle, and a chain buried in
+//                          obstacles keeps its contacts inside the reserved capacity, and a collision aware solve ends with the
+//                          chain less buried than the same solve without the objective. Builds as the ik_test_collision_scene target.
+
+#include "../include/CollisionScene.h"
+#include "../include/IterativeSolver.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <random>
+
+// penetration left at the end of a solve whose collision objective has the given weight
+static double penetrationAfterSolve(const CollisionScene& scene, const std::vector<double>& links, const Eigen::VectorXd& guess, Coord2D target, double weight)
+{
+    const int joints = static_cast<int>(links.size());
+    ChainCollider collider(&scene, joints, 0.1);
+    SecondaryObjectives objectives;
+    objectives.collisionWeight = weight;
+    objectives.collider = &collider;
+
+    IterativeSolver solver;
+    solver.setVerbose(false);
+    solver.setSecondaryObjectives(objectives);
+    const MechanismModel model(links);
+    SolveResult result = solver.newtonSolve(&model, guess, target, 1e-9, 1e-12);
+    if (!IK_CHECK(result.converged())) return 0.0;
+
+    collider.detect(links, result.solution);
+    return collider.totalPenetration();
+}
+
+int main()
+{
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> position(-8.0, 8.0), size(0.05, 0.3), angle(-3.14159, 3.14159);
+
+    CollisionScene scene;
+    for (int i = 0; i < 1000; i++)
+    {
+        const Eigen::Vector2d center(position(rng), position(rng));
+        const double extent = size(rng);
+        if (i % 2) scene.addCircle(center, extent);
+        else scene.addBox(center - Eigen::Vector2d::Constant(extent), center + Eigen::Vector2d::Constant(extent));
+    }
+    CollisionScene allPairs = scene;
+    scene.build();
+
+    // same contacts, link by link and obstacle by obstacle, for random configurations of a chain that fits in the capacity
+    const std::vector<double> links(8, 0.7);
+    ChainCollider hashed(&scene, 8, 0.02, false), exhaustive(&allPairs, 8, 0.02, false);
+    int mismatches = 0, largest = 0;
+    for (int trial = 0; trial < 200; trial++)
+    {
+        Eigen::VectorXd q(8);
+        for (int i = 0; i < 8; i++) q[i] = angle(rng);
+        const int count = hashed.detect(links, q);
+        largest = std::max(largest, count);
+        if (count != exhaustive.detect(links, q)) mismatches++;
+        else
+        {
+            double difference = 0.0;
+            for (const Contact& c : hashed.getContacts())
+            {
+                bool found = false;
+                for (const Contact& d : exhaustive.getContacts()) found = found || (c.link == d.link && c.other == d.other && std::abs(c.depth - d.depth) < 1e-12);
+                if (!found) difference += 1.0;
+            }
+            if (difference > 0.0) mismatches++;
+        }
+    }
+    IK_CHECK(mismatches == 0);
+    IK_CHECK(largest > 0 && largest < static_cast<int>(hashed.getContacts().capacity())); // never capped, or the kept contacts could differ
+
+    // a thick chain lying across thousands of overlapping obstacles: far more overlaps than the capacity holds
+    CollisionScene crowded;
+    for (int i = 0; i < 3000; i++) crowded.addCircle(Eigen::Vector2d(0.001 * i, 0.0), 0.5);
+    crowded.build();
+    ChainCollider collider(&crowded, 3, 0.5, true);
+    const std::size_t capacity = collider.getContacts().capacity();
+    const int found = collider.detect(std::vector<double>(3, 1.0), Eigen::VectorXd::Zero(3));
+    IK_CHECK(found > 0 && static_cast<std::size_t>(found) <= capacity);
+    IK_CHECK(collider.getContacts().capacity() == capacity);
+
+    // the deepest contacts are the ones kept: the obstacles centred on the chain penetrate by the full 1.0
+    bool deepest = true;
+    for (const Contact& c : collider.getContacts()) deepest = deepest && c.depth > 0.99;
+    IK_CHECK(deepest);
+
+    // a redundant chain starting out along a row of obstacles and reaching up to a target above them: without the collision
+    // objective it ends with links still buried in the row, with it the target is met clear of them
+    CollisionScene row;
+    for (int i = 0; i < 6; i++) row.addCircle(Eigen::Vector2d(0.5 + 0.5 * i, 0.0), 0.3);
+    row.build();
+    const std::vector<double> arm(8, 0.5);
+    const Eigen::VectorXd straight = Eigen::VectorXd::Constant(8, 0.05);
+    const double buried = penetrationAfterSolve(row, arm, straight, Coord2D(0.0, 2.0), 0.0);
+    const double avoided = penetrationAfterSolve(row, arm, straight, Coord2D(0.0, 2.0), 0.5);
+    IK_CHECK(buried > 0.5);
+    IK_CHECK(avoided < 0.1 * buried);
+
+    return testResult();
+}
@@ -0,0 +1,73 @@
+// CompiledMechanismTest.cpp : the compiled arrays, invariants and fingerprint of a mechanism, and the bounded solve over them.
+//                             Builds as the ik_test_compiled_mechanism target.
+
+#include "../include/CompiledMechanism.h"
+#include "../include/IterativeSolver.h"
+#include "TestSupport.h"
+#include <cstdint>
+
+static bool aligned(const void* data)
+{
+    return reinterpret_cast<std::uintptr_t>(data) % cacheLineBytes == 0;
+}
+
+int main()
+{
+    const std::vector<double> links = { 1.0, 0.5, 0.25, 3.0 };
+    const CompiledMechanism compiled(links);
+
+    // every array starts on its own cache line and holds what its accessor says
+    IK_CHECK(compiled.getJoints() == 4);
+    IK_CHECK(aligned(&compiled) && aligned(compiled.getLinks()) && aligned(compiled.getCumulativeLengths()) && aligned(compiled.getRemainingReach()));
+    double along = 0.0;
+    for (int i = 0; i < 4; i++)
+    {
+        IK_CHECK(compiled.getLinks()[i] == links[i]);
+        IK_CHECK(compiled.getRemainingReach()[i] == compiled.getReach() - along);
+        along += links[i];
+        IK_CHECK(compiled.getCumulativeLengths()[i] == along);
+    }
+    IK_CHECK(compiled.getReach() == 4.75);
+    IK_CHECK(compiled.getInnerReach() == 1.25); // the 3.0 link less everything else
+    IK_CHECK(compiled.getModel().getLinks() == links);
+
+    // the workspace is the annulus between the inner and outer reach
+    IK_CHECK(compiled.isReachable(Coord2D(0.0, 4.75)) && compiled.isReachable(Coord2D(-1.25, 0.0)) && compiled.isReachable(Coord2D(2.0, -2.0)));
+    IK_CHECK(!compiled.isReachable(Coord2D(0.5, 0.5)) && !compiled.isOutOfReach(Coord2D(0.5, 0.5)));
+    IK_CHECK(!compiled.isReachable(Coord2D(4.0, 3.0)) && compiled.isOutOfReach(Coord2D(4.0, 3.0)));
+    IK_CHECK(CompiledMechanism({ 1.0, 1.0 }).getInnerReach() == 0.0);
+
+    // equal links give equal fingerprints in every instance, and -0 is the same link as +0
+    const MechanismModel model(links);
+    const CompiledMechanism again(model);
+    IK_CHECK(again.getFingerprint() == compiled.getFingerprint() && again.sameLinks(compiled));
+    IK_CHECK(CompiledMechanism::compile(links)->getFingerprint() == compiled.getFingerprint());
+    const CompiledMechanism positiveZero({ 1.0, 0.0 }), negativeZero({ 1.0, -0.0 });
+    IK_CHECK(positiveZero.getFingerprint() == negativeZero.getFingerprint() && positiveZero.sameLinks(negativeZero));
+
+    // any change to the lengths, their order or their count changes both
+    for (const std::vector<double>& other : { std::vector<double>{ 1.0, 0.5, 0.25, 3.0000000000000004 }, std::vector<double>{ 0.5, 1.0, 0.25, 3.0 },
+                                              std::vector<double>{ 1.0, 0.5, 0.25 }, std::vector<double>{ 1.0, 0.5, 0.25, 3.0, 0.0 } })
+    {
+        const CompiledMechanism different(other);
+        IK_CHECK(different.getFingerprint() != compiled.getFingerprint() && !different.sameLinks(compiled));
+    }
+
+    // the bounded solve over the compiled arrays matches the one over the model, and turns unreachable targets away untouched
+    IterativeSolver solver;
+    SolverWorkspace fromModel(4), fromCompiled(4);
+    const Eigen::VectorXd guess = Eigen::VectorXd::Constant(4, 0.3);
+    const Coord2D target(1.5, 2.5);
+    BoundedSolveResult a = solver.newtonSolveBounded(&compiled.getModel(), guess, target, 1e-10, SolveBudget(), fromModel);
+    BoundedSolveResult b = solver.newtonSolveBounded(compiled, guess, target, 1e-10, SolveBudget(), fromCompiled);
+    IK_CHECK(a.status == SolveStatus::Converged && b.status == SolveStatus::Converged);
+    IK_CHECK(a.iterations == b.iterations && fromModel.best == fromCompiled.best);
+
+    for (const Coord2D& unreachable : { Coord2D(6.0, 0.0), Coord2D(0.0, -0.5) })
+    {
+        BoundedSolveResult rejected = solver.newtonSolveBounded(compiled, guess, unreachable, 1e-10, SolveBudget(), fromCompiled);
+        IK_CHECK(rejected.status == SolveStatus::Unreachable && rejected.iterations == 0 && fromCompiled.best == guess);
+    }
+
+    return testResult();
+}
@@ -0,0 +1,88 @@
+// FastTrigTest.cpp : sinCos stays inside the error bounds FastTrig.h documents, measured in ulp against long double
+//                    references, and hands special values to the standard library. Builds as the ik_test_fast_trig target.
+
+#include "../include/FastTrig.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// distance from value to the reference in units of the spacing of doubles at the reference
+static double ulpError(double value, long double reference)
+{
+    const double rounded = static_cast<double>(reference);
+    const double spacing = std::nextafter(std::abs(rounded), std::numeric_limits<double>::infinity()) - std::abs(rounded);
+    return static_cast<double>(std::abs(static_cast<long double>(value) - reference) / spacing);
+}
+
+struct ErrorBound
+{
+    double ulp = 0.0, absolute = 0.0;
+};
+
+static ErrorBound measure(const std::vector<double>& angles)
+{
+    std::vector<double> cosines(angles.size()), sines(angles.size());
+    sinCos(angles.data(), static_cast<int>(angles.size()), cosines.data(), sines.data());
+
+    ErrorBound worst;
+    for (std::size_t i = 0; i < angles.size(); i++)
+    {
+        const long double c = std::cos(static_cast<long double>(angles[i])), s = std::sin(static_cast<long double>(angles[i]));
+        worst.ulp = std::max({ worst.ulp, ulpError(cosines[i], c), ulpError(sines[i], s) });
+        worst.absolute = std::max({ worst.absolute, static_cast<double>(std::abs(cosines[i] - c)), static_cast<double>(std::abs(sines[i] - s)) });
+    }
+    return worst;
+}
+
+int main()
+{
+    std::mt19937_64 rng(45);
+    const int samples = 1 << 20;
+
+    // random angles up to 1000 and up to the reduction limit, plus angles just around multiples of pi/4
+    std::vector<double> small(samples), large(samples), near(samples);
+    std::uniform_real_distribution<double> smallDist(-1000.0, 1000.0), largeDist(-sinCosReductionLimit, sinCosReductionLimit), offset(-1e-6, 1e-6);
+    std::uniform_int_distribution<int> multiple(-4000, 4000);
+    for (int i = 0; i < samples; i++)
+    {
+        small[i] = smallDist(rng);
+        large[i] = largeDist(rng);
+        near[i] = multiple(rng) * 0.78539816339744830962 + offset(rng);
+    }
+
+    const ErrorBound smallError = measure(small), largeError = measure(large), nearError = measure(near);
+    IK_CHECK(smallError.ulp <= 1.6);
+    IK_CHECK(largeError.ulp <= 2.5);
+    IK_CHECK(nearError.ulp <= 1.6);
+    IK_CHECK(std::max({ smallError.absolute, largeError.absolute, nearError.absolute }) <= 2.1e-16);
+    if (testFailures())
+    {
+        std::cerr << "  ulp " << smallError.ulp << " / " << largeError.ulp << " / " << nearError.ulp << ", absolute "
+                  << smallError.absolute << " / " << largeError.absolute << " / " << nearError.absolute << "\n";
+    }
+
+    // every count, including ones that leave a remainder after any vector width
+    for (int count = 0; count <= 17; count++)
+    {
+        std::vector<double> angles(count), cosines(count, 7.0), sines(count, 7.0);
+        for (int i = 0; i < count; i++) angles[i] = 0.37 * i - 2.0;
+        sinCos(angles.data(), count, cosines.data(), sines.data());
+        bool exact = true;
+        for (int i = 0; i < count; i++) exact = exact && std::abs(cosines[i] - std::cos(angles[i])) < 1e-15 && std::abs(sines[i] - std::sin(angles[i])) < 1e-15;
+        IK_CHECK(exact);
+    }
+
+    // special values and angles past the reduction limit go to the standard library
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double special[] = { 0.0, -0.0, std::numeric_limits<double>::quiet_NaN(), infinity, -infinity, 2 * sinCosReductionLimit, -1e300, 1e22 };
+    double cosines[8], sines[8];
+    sinCos(special, 8, cosines, sines);
+    IK_CHECK(cosines[0] == 1.0 && sines[0] == 0.0 && !std::signbit(sines[0]));
+    IK_CHECK(cosines[1] == 1.0 && sines[1] == 0.0 && !std::signbit(sines[1]));
+    for (int i = 2; i < 5; i++) IK_CHECK(std::isnan(cosines[i]) && std::isnan(sines[i]));
+    for (int i = 5; i < 8; i++) IK_CHECK(cosines[i] == std::cos(special[i]) && sines[i] == std::sin(special[i]));
+
+    return testResult();
+}
@@ -0,0 +1,75 @@
+// JacobianReuseTest.cpp : broyden and chord steps converge on the same targets as exact jacobians while evaluating fewer
+//                         jacobians. Builds as the ik_test_jacobian_reuse target.
+
+#include "../include/InitialGuess.h"
+#include "TestSupport.h"
+#include <random>
+
+struct Tally
+{
+    int converged = 0;
+    long long iterations = 0, jacobians = 0;
+};
+
+static Tally solveAll(const MechanismModel& model, const std::vector<Coord2D>& targets, JacobianUpdate mode, StepControl control)
+{
+    IterativeSolver solver;
+    solver.setVerbose(false);
+    solver.setStepControl(control);
+    JacobianReuse reuse;
+    reuse.mode = mode;
+    reuse.refreshInterval = 4;
+    solver.setJacobianReuse(reuse);
+
+    Tally tally;
+    for (const Coord2D& target : targets)
+    {
+        SolveResult result = solver.newtonSolve(&model, optimizeInitialGuess(&model, target), target, 1e-9, 1e-12);
+        const Eigen::Vector2d reached = solver.endEffectorPosition(&model, result.solution);
+        if (result.converged() && (reached - Eigen::Vector2d(target.getX(), target.getY())).norm() < 1e-9) tally.converged++;
+        tally.iterations += result.iterations;
+        tally.jacobians += result.jacobians;
+    }
+    return tally;
+}
+
+int main()
+{
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> length(0.5, 1.5), angle(-3.14159, 3.14159);
+
+    for (int joints : { 3, 8, 32 })
+    {
+        std::vector<double> links(joints);
+        for (double& l : links) l = length(rng);
+        const MechanismModel model(links);
+
+        // forward kinematics of random configurations, so every target is reachable
+        IterativeSolver solver;
+        std::vector<Coord2D> targets;
+        for (int t = 0; t < 200; t++)
+        {
+            Eigen::VectorXd q(joints);
+            for (int i = 0; i < joints; i++) q[i] = angle(rng);
+            const Eigen::Vector2d p = solver.endEffectorPosition(&model, q);
+            targets.emplace_back(p[0], p[1]);
+        }
+
+        for (StepControl control : { StepControl::LineSearch, StepControl::TrustRegion })
+        {
+            const Tally exact = solveAll(model, targets, JacobianUpdate::Exact, control);
+            IK_CHECK(exact.jacobians == exact.iterations);
+            for (JacobianUpdate mode : { JacobianUpdate::Broyden, JacobianUpdate::Chord })
+            {
+                const Tally reused = solveAll(model, targets, mode, control);
+                if (!IK_CHECK(reused.converged >= exact.converged - 4) || !IK_CHECK(reused.jacobians < reused.iterations))
+                {
+                    std::cerr << "  " << joints << " joints, mode " << static_cast<int>(mode) << ", control " << static_cast<int>(control) << ": " << reused.converged << " of " << targets.size()
+                              << " converged against " << exact.converged << " exact, " << reused.jacobians << " jacobians over " << reused.iterations << " iterations\n";
+                }
+            }
+        }
+    }
+
+    return testResult();
+}
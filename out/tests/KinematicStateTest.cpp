@@ -0,0 +1,81 @@
+// KinematicStateTest.cpp : the incremental forward kinematics cache matches a full evaluation after random edits of joints,
+//                          links and whole configurations. Builds as the ik_test_kinematic_state target.
+
+#include "../include/IterativeSolver.h"
+#include "../include/KinematicState.h"
+#include "TestSupport.h"
+#include <random>
+
+int main()
+{
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> angle(-3.14159, 3.14159), length(0.2, 1.5), unit(0.0, 1.0);
+    IterativeSolver solver;
+    solver.setVerbose(false);
+
+    for (int joints : { 1, 2, 7, 64, 300 })
+    {
+        std::vector<double> links(joints);
+        Eigen::VectorXd q(joints);
+        for (int i = 0; i < joints; i++)
+        {
+            links[i] = length(rng);
+            q[i] = angle(rng);
+        }
+        KinematicState state(links, q);
+        Eigen::MatrixXd J(2, joints), expectedJ(2, joints);
+        double worst = 0.0;
+
+        for (int edit = 0; edit < 400; edit++)
+        {
+            const int k = static_cast<int>(unit(rng) * joints) % joints;
+            const double kind = unit(rng);
+            if (kind < 0.5)
+            {
+                q[k] = angle(rng);
+                state.setJointAngle(k, q[k]);
+                IK_CHECK(state.pendingLinks() >= joints - k); // earlier unread edits may reach further down
+            }
+            else if (kind < 0.7)
+            {
+                links[k] = length(rng);
+                state.setLinkLength(k, links[k]);
+            }
+            else
+            {
+                for (int i = k; i < joints; i++) if (unit(rng) < 0.3) q[i] = angle(rng);
+                state.setJointAngles(q);
+            }
+
+            // every few edits, several stacked edits are read at once
+            if (unit(rng) < 0.3) continue;
+
+            const MechanismModel model(links);
+            worst = std::max(worst, (state.endEffector() - solver.endEffectorPosition(&model, q)).norm());
+            IK_CHECK(state.pendingLinks() == 0);
+
+            double absolute = 0.0;
+            Eigen::Vector2d position = Eigen::Vector2d::Zero();
+            for (int i = 0; i < joints; i++)
+            {
+                worst = std::max(worst, (state.jointPosition(i) - position).norm());
+                absolute += q[i];
+                worst = std::max(worst, std::abs(state.absoluteAngle(i) - absolute));
+                position += links[i] * Eigen::Vector2d(std::cos(absolute), std::sin(absolute));
+            }
+            worst = std::max(worst, (state.jointPosition(joints) - position).norm());
+
+            state.jacobian(J.data());
+            IterativeSolver::jacobianKernel(links.data(), q.data(), joints, expectedJ.data());
+            worst = std::max(worst, (J - expectedJ).cwiseAbs().maxCoeff());
+        }
+        IK_CHECK(worst < 1e-9 * joints);
+
+        // unchanged values leave the cache current
+        state.endEffector();
+        state.setJointAngles(q);
+        IK_CHECK(state.pendingLinks() == 0);
+    }
+
+    return testResult();
+}
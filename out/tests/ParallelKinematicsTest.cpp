@@ -0,0 +1,58 @@
+// ParallelKinematicsTest.cpp : the parallel scan kernels agree with the serial ones for chains at and above the parallel
+//                              threshold, when called from a task of their own pool, and through IterativeSolver.
+//                              Builds as the ik_test_parallel_kinematics target.
+
+#include "../include/IterativeSolver.h"
+#include "../include/ParallelKinematics.h"
+#include "../include/ThreadPool.h"
+#include "TestSupport.h"
+#include <random>
+
+// largest difference between the parallel and serial end effector and jacobian of one configuration
+static double deviation(const std::vector<double>& links, const Eigen::VectorXd& q, ThreadPool* pool, int minJoints)
+{
+    const int joints = static_cast<int>(links.size());
+    const Eigen::Vector2d serialTip = parallelEndEffector(links.data(), q.data(), joints, nullptr);
+    const Eigen::Vector2d parallelTip = parallelEndEffector(links.data(), q.data(), joints, pool, minJoints);
+
+    Eigen::MatrixXd serial(2, joints), parallel(2, joints);
+    IterativeSolver::jacobianKernel(links.data(), q.data(), joints, serial.data());
+    parallelJacobianKernel(links.data(), q.data(), joints, parallel.data(), pool, minJoints);
+
+    return std::max((serialTip - parallelTip).lpNorm<Eigen::Infinity>(), (serial - parallel).lpNorm<Eigen::Infinity>());
+}
+
+int main()
+{
+    std::mt19937_64 rng(11);
+    ThreadPool pool(4);
+
+    // at the threshold, above it with blocks of unequal length, and a short chain forced through the parallel path
+    for (int joints : { parallelKinematicsMinJoints, 3 * parallelKinematicsMinJoints + 7, 1001 })
+    {
+        std::uniform_real_distribution<double> length(0.5 / joints, 1.5 / joints), angle(-0.01, 0.01); // reach about 1, curling slowly
+        std::vector<double> links(joints);
+        for (double& l : links) l = length(rng);
+        Eigen::VectorXd q(joints);
+        for (int i = 0; i < joints; i++) q[i] = angle(rng);
+
+        const int minJoints = joints < parallelKinematicsMinJoints ? 0 : parallelKinematicsMinJoints;
+        if (!IK_CHECK(deviation(links, q, &pool, minJoints) < 1e-12)) std::cerr << "  " << joints << " joints\n";
+
+        // from inside a task of the same pool
+        double nested = 1.0;
+        pool.parallelFor(0, 1, 1, [&](int, int) { nested = deviation(links, q, &pool, minJoints); });
+        if (!IK_CHECK(nested < 1e-12)) std::cerr << "  " << joints << " joints, nested\n";
+    }
+
+    // the solver switches to the parallel kernels by itself once it has a pool
+    const int joints = 2 * parallelKinematicsMinJoints;
+    const MechanismModel model(std::vector<double>(joints, 1.0 / joints));
+    const Eigen::VectorXd q = Eigen::VectorXd::LinSpaced(joints, 0.0, 1e-4);
+    IterativeSolver serialSolver, parallelSolver;
+    parallelSolver.setThreadPool(&pool);
+    IK_CHECK((serialSolver.endEffectorPosition(&model, q) - parallelSolver.endEffectorPosition(&model, q)).lpNorm<Eigen::Infinity>() < 1e-12);
+    IK_CHECK((serialSolver.computeJacobian(&model, q) - parallelSolver.computeJacobian(&model, q)).lpNorm<Eigen::Infinity>() < 1e-12);
+
+    return testResult();
+}
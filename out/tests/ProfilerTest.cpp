@@ -0,0 +1,60 @@
+// ProfilerTest.cpp : a thread's trace buffer is a fixed ring that keeps the newest spans, and clear() empties it.
+//                    Builds as the ik_test_profiler target.
+
+#include "../include/Profiler.h"
+#include "TestSupport.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+// the "dur" fields of an exported trace, in file order
+static std::vector<long long> exportedDurations(const std::string& path)
+{
+    std::vector<long long> durations;
+    if (!Profiler::writeChromeTrace(path)) return durations;
+
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    const std::string json = text.str();
+    const std::string key = "\"dur\": ";
+    for (std::size_t at = json.find(key); at != std::string::npos; at = json.find(key, at + 1))
+    {
+        durations.push_back(std::atoll(json.c_str() + at + key.size()));
+    }
+    return durations;
+}
+
+int main()
+{
+    const std::string path = "/tmp/ik_test_profile_" + std::to_string(getpid()) + ".json";
+    const long long overflow = 5;
+
+    // span i lasts i microseconds, so the exported durations tell which spans were kept
+    Profiler::registerThread();
+    for (long long i = 0; i < static_cast<long long>(Profiler::traceCapacity) + overflow; i++)
+    {
+        Profiler::record("span", 0, i * 1000);
+    }
+
+    std::vector<long long> durations = exportedDurations(path);
+    if (IK_CHECK(durations.size() == Profiler::traceCapacity))
+    {
+        IK_CHECK(durations.front() == overflow); // the oldest spans were overwritten
+        IK_CHECK(durations.back() == static_cast<long long>(Profiler::traceCapacity) + overflow - 1);
+        bool ordered = true;
+        for (std::size_t i = 1; i < durations.size(); i++) ordered = ordered && durations[i] == durations[i - 1] + 1;
+        IK_CHECK(ordered);
+    }
+
+    Profiler::clear();
+    Profiler::record("span", 0, 7000);
+    durations = exportedDurations(path);
+    IK_CHECK(durations.size() == 1 && durations[0] == 7);
+
+    std::remove(path.c_str());
+    return testResult();
+}
@@ -0,0 +1,92 @@
+# PythonModuleTest.py : ik_solver module checks, run by ctest against the freshly built module (ik_test_python).
+# Uses array/memoryview buffers so it needs no numpy; numpy arrays go through the same buffer protocol.
+
+import array
+import ctypes
+import math
+import sys
+import threading
+
+import ik_solver
+
+failures = []
+
+
+def check(condition, message):
+    if not condition:
+        failures.append(message)
+        print("check failed:", message, file=sys.stderr)
+
+
+def matrix(values, rows, columns):
+    return memoryview(array.array("d", values)).cast("B").cast("d", [rows, columns])
+
+
+arm = ik_solver.Mechanism([1.0, 0.8, 0.5])
+count = 2000
+flat = []
+for i in range(count):
+    radius, angle = 0.4 + 1.8 * (i % 97) / 97.0, 2.0 * math.pi * (i + 0.5) / count  # off the axes, where the seed is singular
+    flat += [radius * math.cos(angle), radius * math.sin(angle)]
+targets = matrix(flat, count, 2)
+
+solutions, status, iterations, errors = arm.solve(targets)
+check(solutions.shape == (count, 3), "solution shape")
+check(all(s == ik_solver.STATUS_CONVERGED for s in status), "every reachable target converges")
+positions = arm.end_effectors(solutions)
+check(max(abs(positions[i, 0] - targets[i, 0]) + abs(positions[i, 1] - targets[i, 1]) for i in range(count)) < 1e-5,
+      "forward kinematics of the solutions reaches the targets")
+
+# the jacobian modes the tools take by name, and nothing else
+for mode in ("exact", "broyden", "chord"):
+    mode_status = arm.solve(targets, jacobian=mode)[1]
+    check(all(s == ik_solver.STATUS_CONVERGED for s in mode_status), "every reachable target converges with %s jacobians" % mode)
+try:
+    arm.solve(targets, jacobian="secant")
+    check(False, "an unknown jacobian mode is refused")
+except ValueError:
+    pass
+
+# targets beyond the reach come back unreachable, holding the seed
+far_solutions, far_status, far_iterations = arm.solve(matrix([3.0, 0.5, -0.1, 2.4], 2, 2), seeds=array.array("d", [0.1, 0.2, 0.3]))[:3]
+check(all(s == ik_solver.STATUS_UNREACHABLE for s in far_status) and all(n == 0 for n in far_iterations), "unreachable targets are not solved")
+check(far_solutions.tolist() == [[0.1, 0.2, 0.3]] * 2, "unreachable targets keep the seed")
+
+# empty batches give empty results of the right shape instead of a cast error
+no_targets = memoryview((ctypes.c_double * 2 * 0)())
+empty = arm.solve(no_targets)
+check(empty[0].shape == (0, 3) and all(part.shape == (0,) for part in empty[1:]), "an empty batch solves to empty results")
+check(arm.end_effectors(memoryview((ctypes.c_double * 3 * 0)())).shape == (0, 2), "no angles give no positions")
+
+# link lengths the daemon would refuse are refused here too, with the first bad length reported
+for bad in ([1.0, 0.0], [1.0, -0.5], [1.0, float("inf")], [float("nan"), 1.0], [-1.0, "x"]):
+    try:
+        ik_solver.Mechanism(bad)
+        check(False, "links %r are refused" % (bad,))
+    except ValueError:
+        pass
+    except Exception as error:
+        check(False, "links %r raise %r instead of ValueError" % (bad, error))
+
+# solves in several python threads at once, each asking for a different pool size; replacing the shared pool while another
+# thread's batch runs on it used to leave that batch waiting on a destroyed pool
+results = {}
+
+
+def worker(threads):
+    converged = 0
+    for _ in range(20):
+        batch_status = arm.solve(targets, threads=threads)[1]
+        converged += sum(1 for s in batch_status if s == ik_solver.STATUS_CONVERGED)
+    results[threads] = converged
+
+
+workers = [threading.Thread(target=worker, args=(k,)) for k in (1, 2, 3, 4)]
+for thread in workers:
+    thread.start()
+for thread in workers:
+    thread.join(60)
+check(not any(thread.is_alive() for thread in workers), "threads with different pool sizes finish")
+check(all(results.get(k) == 20 * count for k in (1, 2, 3, 4)), "threads with different pool sizes converge on every target")
+
+sys.exit(1 if failures else 0)
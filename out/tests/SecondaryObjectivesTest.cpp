@@ -0,0 +1,120 @@
+// SecondaryObjectivesTest.cpp : joint limit and rest pose objectives only act when their vectors match the chain, and a solve
+//                               with mis-sized ones still converges; the combined gradient is the descent direction of the
+//                               objectives, and the null space step meets the task exactly while lowering them.
+//                               Builds as the ik_test_secondary_objectives target.
+
+#include "../include/IterativeSolver.h"
+#include "TestSupport.h"
+
+// the cost whose negative gradient secondaryObjectiveGradient returns, for the limit, rest pose and manipulability objectives
+static double objectiveCost(const SecondaryObjectives& objectives, const std::vector<double>& links, const Eigen::VectorXd& q)
+{
+    const int joints = static_cast<int>(q.size());
+    Eigen::MatrixXd J(2, joints);
+    IterativeSolver::jacobianKernel(links.data(), q.data(), joints, J.data());
+
+    const Eigen::ArrayXd middle = (objectives.upperLimits + objectives.lowerLimits).array() / 2;
+    const Eigen::ArrayXd halfRange = (objectives.upperLimits - objectives.lowerLimits).array() / 2;
+    return 0.5 * objectives.jointLimitWeight * ((q.array() - middle) / halfRange).square().sum()
+         + 0.5 * objectives.restPoseWeight * (q - objectives.restPose).squaredNorm()
+         - objectives.manipulabilityWeight * std::sqrt((J * J.transpose()).determinant());
+}
+
+static Eigen::Vector2d position(const std::vector<double>& links, const Eigen::VectorXd& q)
+{
+    double x = 0.0, y = 0.0;
+    IterativeSolver::forwardKinematics(links, q, RevoluteJointModel(), x, y);
+    return Eigen::Vector2d(x, y);
+}
+
+int main()
+{
+    const int joints = 4;
+    Eigen::VectorXd q = Eigen::VectorXd::Constant(joints, 0.3);
+    Eigen::MatrixXd J(2, joints);
+    const std::vector<double> links(joints, 1.0);
+    IterativeSolver::jacobianKernel(links.data(), q.data(), joints, J.data());
+    Eigen::VectorXd z(joints);
+
+    // sized for the chain: both objectives pull towards zero
+    SecondaryObjectives objectives;
+    objectives.jointLimitWeight = 1.0;
+    objectives.lowerLimits = Eigen::VectorXd::Constant(joints, -1.0);
+    objectives.upperLimits = Eigen::VectorXd::Constant(joints, 1.0);
+    objectives.restPoseWeight = 1.0;
+    objectives.restPose = Eigen::VectorXd::Zero(joints);
+    secondaryObjectiveGradient(objectives, q.data(), J.data(), joints, z.data());
+    for (int i = 0; i < joints; i++) IK_CHECK_NEAR(z[i], -0.6, 1e-12);
+
+    // sized for a shorter chain: neither objective contributes
+    objectives.lowerLimits.resize(2);
+    objectives.restPose.resize(joints - 1);
+    secondaryObjectiveGradient(objectives, q.data(), J.data(), joints, z.data());
+    IK_CHECK(z.isZero());
+
+    // a solve with the mis-sized objectives set behaves like one without them
+    MechanismModel model(links);
+    IterativeSolver solver;
+    solver.setVerbose(false);
+    solver.setSecondaryObjectives(objectives);
+    SolveResult result = solver.newtonSolve(&model, q, Coord2D(1.5, 2.0), 1e-9, 1e-12);
+    IK_CHECK(result.converged());
+
+    // every objective on, over a bent five link chain
+    const std::vector<double> chain = { 1.0, 0.8, 0.6, 0.5, 0.4 };
+    Eigen::VectorXd bent(5);
+    bent << 0.4, -0.9, 1.2, 0.3, -0.5;
+    SecondaryObjectives all;
+    all.jointLimitWeight = 0.2;
+    all.lowerLimits = Eigen::VectorXd::Constant(5, -1.5);
+    all.upperLimits = Eigen::VectorXd::Constant(5, 2.0);
+    all.restPoseWeight = 0.1;
+    all.restPose = Eigen::VectorXd::Constant(5, 0.2);
+    all.manipulabilityWeight = 0.3;
+    Eigen::MatrixXd Jb(2, 5);
+    IterativeSolver::jacobianKernel(chain.data(), bent.data(), 5, Jb.data());
+    Eigen::VectorXd gradient(5), step(5);
+    secondaryObjectiveGradient(all, bent.data(), Jb.data(), 5, gradient.data());
+
+    // the gradient is minus the derivative of the cost, by central differences
+    for (int i = 0; i < 5; i++)
+    {
+        const double h = 1e-6;
+        Eigen::VectorXd ahead = bent, behind = bent;
+        ahead[i] += h;
+        behind[i] -= h;
+        IK_CHECK_NEAR(gradient[i], -(objectiveCost(all, chain, ahead) - objectiveCost(all, chain, behind)) / (2 * h), 1e-6);
+    }
+
+    // the step moves the end effector by exactly e, with or without a task error
+    for (const Eigen::Vector2d& e : { Eigen::Vector2d(0.3, -0.2), Eigen::Vector2d(0.0, 0.0) })
+    {
+        nullSpaceStep(Jb.data(), 5, e, gradient.data(), step.data());
+        IK_CHECK((Jb * step - e).norm() < 1e-12);
+    }
+
+    // with no task error it is a descent direction that the end effector does not feel
+    IK_CHECK(step.norm() > 1e-3);
+    IK_CHECK(objectiveCost(all, chain, bent + 1e-3 * step) < objectiveCost(all, chain, bent));
+
+    // iterating the step the solver takes, with the task error fed back, holds the end effector on the target while the cost falls
+    const Eigen::Vector2d held = position(chain, bent);
+    Eigen::VectorXd moving = bent;
+    double cost = objectiveCost(all, chain, moving);
+    bool falling = true;
+    for (int i = 0; i < 50; i++)
+    {
+        IterativeSolver::jacobianKernel(chain.data(), moving.data(), 5, Jb.data());
+        secondaryObjectiveGradient(all, moving.data(), Jb.data(), 5, gradient.data());
+        nullSpaceStep(Jb.data(), 5, held - position(chain, moving), gradient.data(), step.data());
+        moving += step;
+        const double next = objectiveCost(all, chain, moving);
+        falling = falling && next < cost + 1e-12; // it settles where the objectives balance, after which only rounding moves it
+        cost = next;
+    }
+    IK_CHECK(falling);
+    IK_CHECK(cost < objectiveCost(all, chain, bent) - 0.1);
+    IK_CHECK((position(chain, moving) - held).norm() < 1e-9);
+
+    return testResult();
+}
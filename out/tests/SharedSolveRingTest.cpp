@@ -0,0 +1,125 @@
+// SharedSolveRingTest.cpp : round trips through the shared memory ring, from one and from several client threads, and a
+//                           server that keeps working when a client rewrites the ring's dimensions in the shared header, and a
+//                           second server that may replace a crashed solver's ring but not a running one's.
+//                           Builds as the ik_test_shared_ring target (linux).
+
+#include "../include/SharedSolveRing.h"
+#include "TestSupport.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static bool reaches(const MechanismModel& model, const Eigen::VectorXd& solution, Coord2D target, double tolerance)
+{
+    IterativeSolver solver;
+    Eigen::Vector2d position = solver.endEffectorPosition(&model, solution);
+    return (position - Eigen::Vector2d(target.getX(), target.getY())).norm() < tolerance;
+}
+
+int main()
+{
+    const std::vector<double> links = { 1.0, 0.8, 0.6, 0.4 };
+    const MechanismModel model(links);
+    const std::string name = "/ik_test_ring_" + std::to_string(getpid());
+
+    SharedRingServer server(links, 2, 4);
+    IK_CHECK(server.start(name, 8));
+
+    SharedRingClient client;
+    IK_CHECK(client.attach(name));
+    IK_CHECK(client.getJoints() == 4);
+    IK_CHECK(client.getFingerprint() == CompiledMechanism(links).getFingerprint());
+
+    // seeded by the solver, and from a guess
+    Eigen::VectorXd solution;
+    const Coord2D target(1.2, 1.1);
+    BoundedSolveResult result = client.solve(target, 1e-9, nullptr, solution);
+    IK_CHECK(result.status == SolveStatus::Converged);
+    IK_CHECK(solution.size() == 4 && reaches(model, solution, target, 1e-8));
+
+    const Eigen::VectorXd guess = Eigen::VectorXd::Constant(4, 0.3);
+    result = client.solve(Coord2D(-0.5, 1.5), 1e-9, &guess, solution);
+    IK_CHECK(result.status == SolveStatus::Converged);
+    IK_CHECK(reaches(model, solution, Coord2D(-0.5, 1.5), 1e-8));
+
+    // a second solver on the same name is turned away and the running one keeps its clients
+    SharedRingServer rival(links);
+    IK_CHECK(!rival.start(name, 8));
+    result = client.solve(target, 1e-9, nullptr, solution);
+    IK_CHECK(result.status == SolveStatus::Converged && reaches(model, solution, target, 1e-8));
+
+    // a target beyond the reach is answered at once with the guess untouched
+    result = client.solve(Coord2D(3.0, 0.5), 1e-9, &guess, solution);
+    IK_CHECK(result.status == SolveStatus::Unreachable && result.iterations == 0 && solution == guess);
+
+    // a guess sized for another chain is refused on the client side
+    const Eigen::VectorXd shortGuess = Eigen::VectorXd::Zero(2);
+    result = client.solve(target, 1e-9, &shortGuess, solution);
+    IK_CHECK(result.status == SolveStatus::BudgetExhausted && std::isinf(result.error));
+
+    // more client threads than slots, so claims wrap around the ring and hit runs the server splits across its pool
+    std::atomic<int> solved(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 12; t++)
+    {
+        threads.emplace_back([&, t] {
+            Eigen::VectorXd own;
+            for (int i = 0; i < 50; i++)
+            {
+                const double angle = 0.1 + 0.37 * (t * 50 + i);
+                const Coord2D point(1.5 * std::cos(angle), 1.5 * std::sin(angle));
+                if (client.solve(point, 1e-9, nullptr, own).status == SolveStatus::Converged && reaches(model, own, point, 1e-8)) solved++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    IK_CHECK(solved.load() >= 12 * 50 * 95 / 100);
+
+    // a client scribbling over the header's dimensions must not move the server's slots
+    int descriptor = shm_open(name.c_str(), O_RDWR, 0);
+    IK_CHECK(descriptor >= 0);
+    void* mapping = mmap(nullptr, sizeof(SharedRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    IK_CHECK(mapping != MAP_FAILED);
+    SharedRingHeader* header = static_cast<SharedRingHeader*>(mapping);
+    header->slots = 1u << 30;
+    header->joints = 100000;
+    header->slotBytes = 1ull << 40;
+
+    result = client.solve(target, 1e-9, nullptr, solution);
+    IK_CHECK(result.status == SolveStatus::Converged);
+    IK_CHECK(reaches(model, solution, target, 1e-8));
+
+    SharedRingClient late;
+    IK_CHECK(!late.attach(name)); // the header no longer describes the segment
+    munmap(mapping, sizeof(SharedRingHeader));
+
+    server.stop();
+
+    // a ring that still says its solver is running, left by a process that has since exited, is replaced
+    const pid_t child = fork();
+    if (child == 0) _exit(0);
+    waitpid(child, nullptr, 0);
+    descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    IK_CHECK(descriptor >= 0 && ftruncate(descriptor, sizeof(SharedRingHeader)) == 0);
+    mapping = mmap(nullptr, sizeof(SharedRingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    IK_CHECK(mapping != MAP_FAILED);
+    header = static_cast<SharedRingHeader*>(mapping);
+    header->version = sharedRingVersion;
+    header->solverPid = child;
+    header->solverRunning.store(1);
+    header->magic.store(sharedRingMagic);
+    munmap(mapping, sizeof(SharedRingHeader));
+
+    SharedRingServer restarted(links);
+    IK_CHECK(restarted.start(name, 8));
+    SharedRingClient fresh;
+    IK_CHECK(fresh.attach(name));
+    result = fresh.solve(target, 1e-9, nullptr, solution);
+    IK_CHECK(result.status == SolveStatus::Converged && reaches(model, solution, target, 1e-8));
+    restarted.stop();
+
+    return testResult();
+}
@@ -0,0 +1,107 @@
+// SolveServiceTest.cpp : round trips through the solve daemon: mechanism loading and its validation, single and pipelined
+//                        solves, refused requests, and a client that never reads its replies next to one that does.
+//                        Builds as the ik_test_solve_service target (posix).
+
+#include "../include/SolveClient.h"
+#include "../include/SolveServer.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <limits>
+#include <set>
+#include <unistd.h>
+
+static bool reaches(const std::vector<double>& links, const Eigen::VectorXd& solution, Coord2D target, double tolerance)
+{
+    MechanismModel model(links);
+    IterativeSolver solver;
+    Eigen::Vector2d position = solver.endEffectorPosition(&model, solution);
+    return (position - Eigen::Vector2d(target.getX(), target.getY())).norm() < tolerance;
+}
+
+int main()
+{
+    ServerConfig config;
+    config.socketPath = "/tmp/ik_test_service_" + std::to_string(getpid()) + ".sock";
+    config.threads = 2;
+    config.maxMechanisms = 3;
+    config.maxReplyBacklog = 64 * 1024;
+    SolveServer server(config);
+    IK_CHECK(server.start());
+
+    SolveClient client;
+    IK_CHECK(client.connect(config.socketPath));
+
+    // the same links share an id; invalid links and a fourth distinct mechanism are refused
+    const std::vector<double> links = { 1.0, 0.8, 0.6, 0.4 };
+    const std::uint32_t id = client.loadMechanism(links);
+    IK_CHECK(id != 0);
+    IK_CHECK(client.loadMechanism(links) == id);
+    for (int i = 0; i < 10; i++) IK_CHECK(client.loadMechanism({ 1.0, std::numeric_limits<double>::quiet_NaN() }) == 0);
+    IK_CHECK(client.loadMechanism({ 1.0, 0.0 }) == 0);
+    IK_CHECK(client.loadMechanism({ 1.0, -0.5 }) == 0);
+    IK_CHECK(client.loadMechanism({ 1.0, std::numeric_limits<double>::infinity() }) == 0);
+    IK_CHECK(client.loadMechanism({ 1.0, 1.0 }) != 0);
+    IK_CHECK(client.loadMechanism({ 2.0, 1.0 }) != 0);
+    IK_CHECK(client.loadMechanism({ 3.0, 1.0 }) == 0);
+    IK_CHECK(client.loadMechanism(links) == id);
+
+    ServiceStats current;
+    IK_CHECK(client.stats(current));
+    IK_CHECK(current.mechanisms == 3);
+
+    // single solves, seeded by the daemon and from a guess
+    RemoteSolveResult result;
+    const Coord2D target(1.2, 1.1);
+    IK_CHECK(client.solve(id, target, 1e-9, result));
+    IK_CHECK(result.converged() && reaches(links, result.solution, target, 1e-8));
+    const Eigen::VectorXd guess = Eigen::VectorXd::Constant(4, 0.3);
+    IK_CHECK(client.solve(id, Coord2D(-0.5, 1.5), 1e-9, result, &guess));
+    IK_CHECK(result.converged() && reaches(links, result.solution, Coord2D(-0.5, 1.5), 1e-8));
+
+    // a target beyond the reach is answered without iterating, with the guess as the solution
+    IK_CHECK(client.solve(id, Coord2D(3.0, 0.5), 1e-9, result, &guess));
+    IK_CHECK(result.failure == ServiceError::None && result.status == SolveStatus::Unreachable && result.iterations == 0 && result.solution == guess);
+
+    // refused solves
+    const Eigen::VectorXd shortGuess = Eigen::VectorXd::Zero(2);
+    IK_CHECK(client.solve(id, target, 1e-9, result, &shortGuess));
+    IK_CHECK(result.failure == ServiceError::BadRequest);
+    IK_CHECK(client.solve(99, target, 1e-9, result));
+    IK_CHECK(result.failure == ServiceError::UnknownMechanism);
+
+    // pipelined solves come back once each, in any order
+    std::set<std::uint32_t> outstanding;
+    for (int i = 0; i < 64; i++) outstanding.insert(client.submitSolve(id, Coord2D(1.5 * std::cos(0.1 * i + 0.05), 1.5 * std::sin(0.1 * i + 0.05)), 1e-9));
+    int converged = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        IK_CHECK(client.receiveSolve(result));
+        IK_CHECK(outstanding.erase(result.requestId) == 1);
+        if (result.converged()) converged++;
+    }
+    IK_CHECK(outstanding.empty() && converged >= 60);
+
+    // a client that never reads: its replies pile up until it is disconnected, and everyone else keeps being answered
+    SolveClient silent;
+    IK_CHECK(silent.connect(config.socketPath));
+    int submitted = 0;
+    while (submitted < 50000 && silent.submitSolve(id, target, 1e-9) != 0) submitted++;
+    IK_CHECK(client.solve(id, target, 1e-9, result));
+    IK_CHECK(result.converged());
+
+    bool disconnected = false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (!disconnected && std::chrono::steady_clock::now() < deadline)
+    {
+        IK_CHECK(client.stats(current));
+        disconnected = current.connections == 1;
+        if (!disconnected) usleep(10000);
+    }
+    IK_CHECK(disconnected);
+    IK_CHECK(client.solve(id, target, 1e-9, result) && result.converged());
+
+    client.close();
+    silent.close();
+    server.stop();
+    return testResult();
+}
@@ -0,0 +1,64 @@
+// SolveTraceTest.cpp : a recorded trace survives the binary format bit for bit, and damaged files are refused.
+//                      Builds as the ik_test_solve_trace target.
+
+#include "../include/InitialGuess.h"
+#include "TestSupport.h"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+static bool sameTrace(const SolveTrace& a, const SolveTrace& b)
+{
+    return a.getJoints() == b.getJoints() && a.getIterations() == b.getIterations() && a.getErrorNorms() == b.getErrorNorms() &&
+        a.getStepNorms() == b.getStepNorms() && a.jointAngles() == b.jointAngles();
+}
+
+int main()
+{
+    const std::string path = "/tmp/ik_test_trace_" + std::to_string(getpid()) + ".bin";
+
+    // a real solve's trace
+    const MechanismModel model({ 1.0, 0.7, 0.5, 0.3, 0.2 });
+    IterativeSolver solver;
+    solver.setVerbose(false);
+    const Coord2D target(1.1, 1.3);
+    SolveResult result = solver.newtonSolve(&model, optimizeInitialGuess(&model, target), target, 1e-12, 1e-14, true);
+    IK_CHECK(result.trace.getIterations() == result.iterations + 1);
+    IK_CHECK(result.trace.getJoints() == 5);
+    IK_CHECK(result.trace.iterate(result.trace.getIterations() - 1) == result.solution);
+
+    IK_CHECK(result.trace.writeBinary(path));
+    SolveTrace loaded;
+    IK_CHECK(loaded.readBinary(path));
+    IK_CHECK(sameTrace(result.trace, loaded));
+
+    // an empty trace
+    SolveTrace empty, emptyLoaded;
+    empty.reset(3);
+    IK_CHECK(empty.writeBinary(path) && emptyLoaded.readBinary(path));
+    IK_CHECK(emptyLoaded.getJoints() == 3 && emptyLoaded.getIterations() == 0);
+
+    // truncated, padded, wrong magic, and a header claiming far more than the file holds
+    IK_CHECK(result.trace.writeBinary(path));
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    auto refused = [&](const std::string& contents) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size());
+        SolveTrace trace;
+        return !trace.readBinary(path);
+    };
+    IK_CHECK(refused(bytes.substr(0, bytes.size() - 8)));
+    IK_CHECK(refused(bytes + std::string(8, '\0')));
+    IK_CHECK(refused("IKTRACE2" + bytes.substr(8)));
+    std::string huge = bytes;
+    const std::int32_t claimed[2] = { 1 << 30, 1 << 30 };
+    huge.replace(8, sizeof(claimed), reinterpret_cast<const char*>(claimed), sizeof(claimed));
+    IK_CHECK(refused(huge));
+    IK_CHECK(refused(""));
+
+    std::remove(path.c_str());
+    return testResult();
+}
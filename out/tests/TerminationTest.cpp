@@ -0,0 +1,51 @@
+// TerminationTest.cpp : full newton steps that are not going to converge end on the stall or oscillation windows long before the
+//                       iteration cap, without cutting off solves that would have converged. Builds as the ik_test_termination target.
+
+#include "../include/InitialGuess.h"
+#include "TestSupport.h"
+
+int main()
+{
+    const MechanismModel model({ 1.0, 1.0 });
+    IterativeSolver solver;
+    solver.setVerbose(false);
+    solver.setStepControl(StepControl::Full);
+
+    // reachable, but the quadrant seed sends undamped steps wandering around the workspace for good
+    const Coord2D wandering(-0.590625, 1.115625);
+    SolveResult failed = solver.newtonSolve(&model, optimizeInitialGuess(&model, wandering), wandering, 1e-6, 1e-6);
+    IK_CHECK(failed.status == SolveStatus::Stalled || failed.status == SolveStatus::Oscillating);
+    IK_CHECK(failed.iterations <= solver.getTermination().maxIterations / 4);
+
+    // the same sweep with the full step windows switched off: exactly the same solves converge, and none of the failures the
+    // windows catch runs to the cap
+    IterativeSolver unwatched;
+    unwatched.setVerbose(false);
+    unwatched.setStepControl(StepControl::Full);
+    Termination off;
+    off.fullStepStallWindow = off.fullStepOscillationWindow = 0;
+    unwatched.setTermination(off);
+
+    const int n = 41;
+    int converged = 0, convergedUnwatched = 0, capped = 0, cappedUnwatched = 0;
+    for (int row = 0; row < n; row++)
+    {
+        for (int col = 0; col < n; col++)
+        {
+            const Coord2D target(2.1 * (2.0 * col - (n - 1)) / (n - 1), 2.1 * ((n - 1) - 2.0 * row) / (n - 1));
+            if (model.isOutOfReach(target)) continue;
+
+            SolveResult watched = solver.newtonSolve(&model, optimizeInitialGuess(&model, target), target, 1e-6, 1e-6);
+            SolveResult plain = unwatched.newtonSolve(&model, optimizeInitialGuess(&model, target), target, 1e-6, 1e-6);
+            converged += watched.converged();
+            convergedUnwatched += plain.converged();
+            capped += watched.status == SolveStatus::BudgetExhausted;
+            cappedUnwatched += plain.status == SolveStatus::BudgetExhausted;
+        }
+    }
+    IK_CHECK(converged == convergedUnwatched);
+    IK_CHECK(cappedUnwatched > 0);
+    IK_CHECK(capped == 0);
+
+    return testResult();
+}
@@ -0,0 +1,34 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <cmath>
+#include <iostream>
+
+// minimal checks for the ctest executables: a failed check prints where it failed and carries on, and main returns
+// testResult() so ctest sees a non-zero exit whenever any check failed
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline bool testCheck(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+        testFailures()++;
+    }
+    return condition;
+}
+
+#define IK_CHECK(condition) testCheck(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+#define IK_CHECK_NEAR(a, b, tolerance) testCheck(std::abs((a) - (b)) <= (tolerance), #a " == " #b " within " #tolerance, __FILE__, __LINE__)
+
+inline int testResult()
+{
+    if (testFailures()) std::cerr << testFailures() << " check(s) failed\n";
+    return testFailures() ? 1 : 0;
+}
+
+#endif // TESTSUPPORT_H
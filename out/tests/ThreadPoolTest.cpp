@@ -0,0 +1,65 @@
+// ThreadPoolTest.cpp : parallelFor coverage, nesting, and independence from other loops and tasks on the same pool.
+//                      Builds as the ik_test_thread_pool target.
+
+#include "../include/ThreadPool.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+int main()
+{
+    ThreadPool pool(2);
+
+    // every index exactly once, for ranges that do and do not divide by the grain
+    for (int count : { 0, 1, 7, 64, 1000 })
+    {
+        std::vector<std::atomic<int>> hits(count);
+        pool.parallelFor(0, count, 3, [&](int first, int last) {
+            for (int i = first; i < last; i++) hits[i]++;
+        });
+        bool once = true;
+        for (std::atomic<int>& hit : hits) once = once && hit.load() == 1;
+        IK_CHECK(once);
+    }
+
+    // nested: every worker runs an outer chunk that issues its own parallelFor on the same pool
+    std::atomic<long long> sum(0);
+    pool.parallelFor(0, 8, 1, [&](int first, int last) {
+        for (int outer = first; outer < last; outer++)
+        {
+            pool.parallelFor(0, 100, 10, [&](int innerFirst, int innerLast) {
+                for (int i = innerFirst; i < innerLast; i++) sum += i;
+            });
+        }
+    });
+    IK_CHECK(sum.load() == 8 * 4950);
+
+    // a loop must not wait for an unrelated task that is still running
+    std::atomic<bool> release(false);
+    pool.submit([&] {
+        while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    std::atomic<int> ran(0);
+    pool.parallelFor(0, 16, 2, [&](int first, int last) { ran += last - first; });
+    IK_CHECK(ran.load() == 16);
+    release = true;
+    pool.wait();
+
+    // concurrent loops from outside threads
+    std::atomic<int> total(0);
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; t++)
+    {
+        callers.emplace_back([&] {
+            for (int repeat = 0; repeat < 50; repeat++)
+            {
+                pool.parallelFor(0, 40, 3, [&](int first, int last) { total += last - first; });
+            }
+        });
+    }
+    for (std::thread& caller : callers) caller.join();
+    IK_CHECK(total.load() == 4 * 50 * 40);
+
+    return testResult();
+}
@@ -0,0 +1,65 @@
+// TripleBufferTest.cpp : the reader only ever sees whole published values, newest first and never going back, while a writer
+//                        thread publishes as fast as it can. Builds as the ik_test_triple_buffer target.
+
+#include "../include/TripleBuffer.h"
+#include "TestSupport.h"
+#include <thread>
+#include <vector>
+
+struct Frame
+{
+    long long sequence = 0;
+    std::vector<long long> payload; // every entry equals sequence in a whole frame
+};
+
+int main()
+{
+    // single thread: nothing new until a publish, then the newest of several
+    {
+        TripleBuffer<int> buffer;
+        IK_CHECK(!buffer.update());
+        buffer.writeSlot() = 1;
+        buffer.publish();
+        buffer.writeSlot() = 2;
+        buffer.publish();
+        IK_CHECK(buffer.update());
+        IK_CHECK(buffer.readSlot() == 2);
+        IK_CHECK(!buffer.update());
+        IK_CHECK(buffer.readSlot() == 2);
+        buffer.writeSlot() = 3;
+        buffer.publish();
+        IK_CHECK(buffer.update() && buffer.readSlot() == 3);
+    }
+
+    // one writer, one reader
+    TripleBuffer<Frame> buffer;
+    const long long frames = 200000;
+    std::thread writer([&] {
+        for (long long s = 1; s <= frames; s++)
+        {
+            Frame& frame = buffer.writeSlot();
+            frame.sequence = s;
+            frame.payload.assign(64, s);
+            buffer.publish();
+        }
+    });
+
+    long long last = 0, torn = 0, backwards = 0, updates = 0;
+    while (last < frames)
+    {
+        if (!buffer.update()) continue;
+        updates++;
+        const Frame& frame = buffer.readSlot();
+        for (long long value : frame.payload) torn += value != frame.sequence;
+        backwards += frame.sequence <= last;
+        last = frame.sequence;
+    }
+    writer.join();
+
+    IK_CHECK(torn == 0);
+    IK_CHECK(backwards == 0);
+    IK_CHECK(updates > 0 && last == frames);
+    IK_CHECK(!buffer.update());
+
+    return testResult();
+}
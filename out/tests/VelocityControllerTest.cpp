@@ -0,0 +1,107 @@
+// VelocityControllerTest.cpp : the controller's joint velocities stay inside the velocity and position derived bounds,
+//                              for configurations inside the limits, on a limit and already past one.
+//                              Builds as the ik_test_velocity_controller target.
+
+#include "../include/IterativeSolver.h"
+#include "../include/VelocityController.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <random>
+
+static const double dt = 0.01;
+
+// the bounds the controller promises, computed the same way the header describes them
+static bool feasible(const Eigen::VectorXd& q, const Eigen::VectorXd& qdot, const Eigen::VectorXd& maxVelocity, const Eigen::VectorXd& lowerLimit, const Eigen::VectorXd& upperLimit)
+{
+    for (int i = 0; i < q.size(); i++)
+    {
+        double lower = std::max(-maxVelocity[i], (lowerLimit[i] - q[i]) / dt);
+        double upper = std::min(maxVelocity[i], (upperLimit[i] - q[i]) / dt);
+        if (lower > upper) lower = upper = (lower + upper) / 2;
+        if (qdot[i] < lower - 1e-9 || qdot[i] > upper + 1e-9) return false;
+    }
+    return true;
+}
+
+int main()
+{
+    const std::vector<double> links = { 1.0, 1.0, 1.0 };
+    const double infinity = std::numeric_limits<double>::infinity();
+    Eigen::VectorXd maxVelocity = Eigen::VectorXd::Constant(3, infinity);
+    Eigen::VectorXd lowerLimit = Eigen::VectorXd::Constant(3, -1.0);
+    Eigen::VectorXd upperLimit = Eigen::VectorXd::Constant(3, 1.0);
+
+    VelocityController controller(links, dt);
+    controller.setPositionLimits(lowerLimit, upperLimit);
+    Eigen::VectorXd qdot(3);
+    Eigen::MatrixXd J(2, 3);
+
+    // inside the limits with a small request: nothing saturates and the cartesian velocity is met exactly
+    {
+        Eigen::VectorXd q(3);
+        q << 0.2, 0.3, -0.4;
+        const Eigen::Vector2d v(0.05, -0.02);
+        IK_CHECK(controller.computeJointVelocities(q, v, qdot) == 0);
+        IterativeSolver::jacobianKernel(links.data(), q.data(), 3, J.data());
+        IK_CHECK(((J * qdot) - v).norm() < 1e-9);
+        IK_CHECK(feasible(q, qdot, maxVelocity, lowerLimit, upperLimit));
+    }
+
+    // already past the lower limit of joint 0: its lower bound is +0.5 rad/s, whatever the task asks for
+    {
+        Eigen::VectorXd q(3);
+        q << -1.005, 0.3, 0.3;
+        for (const Eigen::Vector2d& v : { Eigen::Vector2d(0.0, 0.0), Eigen::Vector2d(0.3, 0.1), Eigen::Vector2d(-0.5, 0.2), Eigen::Vector2d(0.0, -1.0) })
+        {
+            const int saturatedJoints = controller.computeJointVelocities(q, v, qdot);
+            IK_CHECK(qdot[0] >= 0.5 - 1e-9);
+            if (v.isZero()) IK_CHECK(saturatedJoints >= 1); // holding still would leave it outside, so joint 0 must be saturated
+            IK_CHECK(feasible(q, qdot, maxVelocity, lowerLimit, upperLimit));
+        }
+    }
+
+    // exactly on the lower limit and pushed further out: the joint may not move below it
+    {
+        Eigen::VectorXd q(3);
+        q << -1.0, 0.5, 0.5;
+        IterativeSolver::jacobianKernel(links.data(), q.data(), 3, J.data());
+        const Eigen::Vector2d v = -J.col(0); // exactly what joint 0 alone moving negative would produce
+        controller.computeJointVelocities(q, v, qdot);
+        IK_CHECK(qdot[0] >= -1e-9);
+        IK_CHECK(feasible(q, qdot, maxVelocity, lowerLimit, upperLimit));
+    }
+
+    // random configurations around the limits, with velocity limits as well
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> angle(-1.05, 1.05), speed(-3.0, 3.0);
+    maxVelocity = Eigen::VectorXd::Constant(3, 2.0);
+    controller.setVelocityLimits(maxVelocity);
+    int infeasible = 0;
+    for (int trial = 0; trial < 5000; trial++)
+    {
+        Eigen::VectorXd q(3);
+        q << angle(rng), angle(rng), angle(rng);
+        controller.computeJointVelocities(q, Eigen::Vector2d(speed(rng), speed(rng)), qdot);
+        if (!feasible(q, qdot, maxVelocity, lowerLimit, upperLimit)) infeasible++;
+    }
+    IK_CHECK(infeasible == 0);
+
+    // mis-sized limits are refused and the previous ones stay in force; mis-sized q or qdot are refused before anything is read
+    IK_CHECK(!controller.setVelocityLimits(Eigen::VectorXd::Constant(2, 0.1)));
+    IK_CHECK(!controller.setPositionLimits(Eigen::VectorXd::Constant(1, -0.1), Eigen::VectorXd::Constant(1, 0.1)));
+    IK_CHECK(!controller.setPositionLimits(lowerLimit, Eigen::VectorXd::Constant(4, 0.1)));
+    {
+        Eigen::VectorXd q(3);
+        q << 0.2, 0.3, -0.4;
+        const Eigen::Vector2d v(2.0, -2.0);
+        controller.computeJointVelocities(q, v, qdot);
+        IK_CHECK(feasible(q, qdot, maxVelocity, lowerLimit, upperLimit));
+
+        Eigen::VectorXd shortVelocities = Eigen::VectorXd::Constant(2, 7.0);
+        IK_CHECK(controller.computeJointVelocities(q, v, shortVelocities) == -1);
+        IK_CHECK(shortVelocities == Eigen::VectorXd::Constant(2, 7.0));
+        IK_CHECK(controller.computeJointVelocities(Eigen::VectorXd::Zero(2), v, qdot) == -1);
+    }
+
+    return testResult();
+}
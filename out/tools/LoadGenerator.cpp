@@ -0,0 +1,152 @@
+// LoadGenerator.cpp : drives an ik_daemon from many concurrent clients and reports throughput and round trip latency.
+//                     Builds as the ik_loadgen target (posix only).
+
+#include "../include/SolveClient.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// command line configuration
+struct LoadConfig
+{
+    std::string socketPath = "/tmp/ik_solver.sock";
+    int clients = 4;            // connections, one thread each
+    int window = 8;             // solves each client keeps in flight
+    double seconds = 5;
+    int joints = 16;            // unit links
+    double tolerance = 1e-6;
+    unsigned long long seed = 42;
+};
+
+// what one client thread saw
+struct ClientTally
+{
+    std::vector<double> latencies;  // microseconds, submit to reply
+    long long failures = 0;         // refused or not converged
+    long long batchSizes = 0;       // summed over replies
+    bool ok = true;
+};
+
+static bool parseArguments(int argc, char** argv, LoadConfig& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--socket" && hasValue) config.socketPath = argv[++i];
+        else if (arg == "--clients" && hasValue) config.clients = std::atoi(argv[++i]);
+        else if (arg == "--window" && hasValue) config.window = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && hasValue) config.seconds = std::atof(argv[++i]);
+        else if (arg == "--joints" && hasValue) config.joints = std::atoi(argv[++i]);
+        else if (arg == "--tolerance" && hasValue) config.tolerance = std::atof(argv[++i]);
+        else if (arg == "--seed" && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            std::cerr << "usage: ik_loadgen [--socket PATH] [--clients N] [--window N] [--seconds S] [--joints N] [--tolerance T] [--seed S]\n";
+            return false;
+        }
+    }
+
+    return config.clients >= 1 && config.window >= 1 && config.seconds > 0 && config.joints >= 1;
+}
+
+// keeps window solves in flight until the time is up, then drains them
+static void runClient(const LoadConfig& config, int index, ClientTally& tally)
+{
+    using Clock = std::chrono::steady_clock;
+
+    SolveClient client;
+    std::uint32_t mechanism = 0;
+    if (!client.connect(config.socketPath) || (mechanism = client.loadMechanism(std::vector<double>(config.joints, 1.0))) == 0)
+    {
+        tally.ok = false;
+        return;
+    }
+
+    std::mt19937_64 rng(config.seed + index);
+    std::uniform_real_distribution<double> radius(0.2 * config.joints, 0.9 * config.joints), angle(-3.14159265358979, 3.14159265358979);
+    std::unordered_map<std::uint32_t, Clock::time_point> sent;
+    RemoteSolveResult result;
+
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.seconds));
+    while (true)
+    {
+        const bool running = Clock::now() < end;
+        while (running && static_cast<int>(sent.size()) < config.window)
+        {
+            double r = radius(rng), a = angle(rng);
+            std::uint32_t id = client.submitSolve(mechanism, Coord2D(r * std::cos(a), r * std::sin(a)), config.tolerance);
+            if (id == 0)
+            {
+                tally.ok = false;
+                return;
+            }
+            sent.emplace(id, Clock::now());
+        }
+        if (sent.empty()) return;
+
+        if (!client.receiveSolve(result))
+        {
+            tally.ok = false;
+            return;
+        }
+        auto found = sent.find(result.requestId);
+        if (found == sent.end()) continue;
+
+        tally.latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - found->second).count());
+        tally.batchSizes += result.batchSize;
+        if (!result.converged()) tally.failures++;
+        sent.erase(found);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    LoadConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    std::vector<ClientTally> tallies(config.clients);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < config.clients; c++) threads.emplace_back(runClient, std::cref(config), c, std::ref(tallies[c]));
+    for (std::thread& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> latencies;
+    long long failures = 0, batchSizes = 0;
+    int broken = 0;
+    for (const ClientTally& tally : tallies)
+    {
+        latencies.insert(latencies.end(), tally.latencies.begin(), tally.latencies.end());
+        failures += tally.failures;
+        batchSizes += tally.batchSizes;
+        if (!tally.ok) broken++;
+    }
+    if (broken) std::cerr << broken << " of " << config.clients << " clients lost their connection to " << config.socketPath << "\n";
+    if (latencies.empty()) return 1;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))]; };
+    std::printf("%zu solves in %.2f s: %.0f solves/s, %lld failed, mean batch %.2f\n", latencies.size(), seconds, latencies.size() / seconds,
+        failures, static_cast<double>(batchSizes) / latencies.size());
+    std::printf("round trip us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n", percentile(0.50), percentile(0.90), percentile(0.99), latencies.back());
+
+    SolveClient client;
+    ServiceStats stats;
+    if (client.connect(config.socketPath) && client.stats(stats))
+    {
+        std::printf("daemon: requests %llu  batches %llu  mean batch %.2f  max batch %u  max queue %u  latency us p50 %.1f p99 %.1f\n",
+            static_cast<unsigned long long>(stats.requests), static_cast<unsigned long long>(stats.batches), stats.meanBatch, stats.maxBatch,
+            stats.maxQueueDepth, stats.latencyP50, stats.latencyP99);
+    }
+
+    return broken ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+// RenderSolves.cpp : solves many targets in parallel and renders every iteration of each solve to an image sequence.
+//                    Builds as the ik_render target; needs no display or GL context.
+
+#include "../include/InitialGuess.h"
+#include "../include/NewtonStepper.h"
+#include "../include/SoftwareRenderer.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+// command line configuration
+struct RenderConfig
+{
+    std::vector<double> links = { 1.0, 1.0 };
+    std::string targetsPath;        // csv of x,y per line; empty means random targets
+    int randomTargets = 16;
+    unsigned long long seed = 42;
+    int width = 512, height = 512;
+    std::string outputDir = "frames";
+    std::string format = "png";     // png or ppm
+    unsigned threads = 0;           // zero means one per hardware thread
+};
+
+static std::vector<double> parseList(const std::string& text)
+{
+    std::vector<double> values;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) values.push_back(std::atof(item.c_str()));
+    return values;
+}
+
+static bool parseArguments(int argc, char** argv, RenderConfig& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--links" && hasValue) config.links = parseList(argv[++i]);
+        else if (arg == "--targets" && hasValue) config.targetsPath = argv[++i];
+        else if (arg == "--random" && hasValue) config.randomTargets = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--size" && hasValue)
+        {
+            std::vector<double> size = parseList(argv[++i]);
+            config.width = size.size() > 0 ? static_cast<int>(size[0]) : 0;
+            config.height = size.size() > 1 ? static_cast<int>(size[1]) : config.width;
+        }
+        else if (arg == "--output" && hasValue) config.outputDir = argv[++i];
+        else if (arg == "--format" && hasValue) config.format = argv[++i];
+        else if (arg == "--threads" && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else
+        {
+            std::cerr << "usage: ik_render [--links L1,L2,...] [--targets FILE | --random N] [--seed S] [--size W,H] [--output DIR] [--format png|ppm] [--threads N]\n";
+            return false;
+        }
+    }
+
+    bool positiveLinks = !config.links.empty() && std::all_of(config.links.begin(), config.links.end(), [](double l) { return l > 0.0; });
+    return positiveLinks && config.width > 0 && config.height > 0 && (config.format == "png" || config.format == "ppm");
+}
+
+static std::vector<Coord2D> loadTargets(const RenderConfig& config)
+{
+    std::vector<Coord2D> targets;
+
+    if (!config.targetsPath.empty())
+    {
+        std::ifstream file(config.targetsPath);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::vector<double> xy = parseList(line);
+            if (xy.size() >= 2) targets.emplace_back(xy[0], xy[1]);
+        }
+        return targets;
+    }
+
+    // random targets inside the reachable disc
+    double reach = 0.0;
+    for (double l : config.links) reach += l;
+
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int i = 0; i < config.randomTargets; i++)
+    {
+        double r = reach * std::sqrt(unit(rng)), a = 2.0 * M_PI * unit(rng);
+        targets.emplace_back(r * std::cos(a), r * std::sin(a));
+    }
+    return targets;
+}
+
+int main(int argc, char** argv)
+{
+    RenderConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    std::vector<Coord2D> targets = loadTargets(config);
+    std::filesystem::create_directories(config.outputDir);
+
+    MechanismModel mechanism(config.links);
+    MechanismModel* m = &mechanism;
+    std::vector<float> linkLengths(config.links.begin(), config.links.end());
+
+    std::atomic<int> frames{ 0 }, failures{ 0 };
+    ThreadPool pool(config.threads);
+
+    // one solve per task, each with its own renderer and image buffer
+    pool.parallelFor(0, static_cast<int>(targets.size()), 1, [&](int begin, int end) {
+        IterativeSolver solver;
+        solver.setVerbose(false);
+        SoftwareRenderer renderer(config.width, config.height);
+        std::vector<float> jointAngles(linkLengths.size());
+
+        for (int t = begin; t < end; t++)
+        {
+            const Coord2D& target = targets[t];
+            if (m->isOutOfReach(target)) continue;
+
+            // each iterate is rendered as soon as it is computed, so no history is kept
+            NewtonStepper stepper(solver, m, optimizeInitialGuess(m, target), target, 1e-6);
+
+            for (int i = 0; ; i++)
+            {
+                const Eigen::VectorXd& iterate = stepper.iterate();
+                for (size_t j = 0; j < jointAngles.size(); j++) jointAngles[j] = static_cast<float>(iterate[j]);
+
+                renderer.clear();
+                renderer.drawDottedAxis();
+                renderer.drawMechanism(linkLengths, jointAngles);
+                renderer.drawDesiredPosition(static_cast<float>(target.getX()), static_cast<float>(target.getY()));
+
+                char name[64];
+                std::snprintf(name, sizeof(name), "/solve_%05d_frame_%04d.", t, i);
+                std::string path = config.outputDir + name + config.format;
+
+                bool written = config.format == "png" ? renderer.writePNG(path) : renderer.writePPM(path);
+                if (written) frames++;
+                else failures++;
+
+                if (!stepper.step()) break;
+            }
+        }
+    });
+
+    std::printf("Rendered %d frames for %zu targets into %s.\n", frames.load(), targets.size(), config.outputDir.c_str());
+    if (failures > 0)
+    {
+        std::cerr << failures << " frames could not be written.\n";
+        return 1;
+    }
+
+    return 0;
+}
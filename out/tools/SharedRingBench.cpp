@@ -0,0 +1,149 @@
+// SharedRingBench.cpp : measures round trip latency through the shared memory ring between two processes.
+//                       Builds as the ik_shmbench target (linux); forks a solver process and drives it from client threads.
+
+#include "../include/SharedSolveRing.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+// command line configuration
+struct RingBenchConfig
+{
+    std::string segment = "/ik_ring_bench";
+    int joints = 8;             // unit links
+    int clients = 1;            // client threads, each with one request in flight
+    double seconds = 2;
+    unsigned threads = 1;       // solver threads
+    std::uint32_t slots = 64;
+    int spinIterations = RingWait().spinIterations; // negative busy-polls on both sides
+};
+
+static bool parseArguments(int argc, char** argv, RingBenchConfig& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--segment" && hasValue) config.segment = argv[++i];
+        else if (arg == "--joints" && hasValue) config.joints = std::atoi(argv[++i]);
+        else if (arg == "--clients" && hasValue) config.clients = std::atoi(argv[++i]);
+        else if (arg == "--seconds" && hasValue) config.seconds = std::atof(argv[++i]);
+        else if (arg == "--threads" && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--slots" && hasValue) config.slots = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--spin" && hasValue) config.spinIterations = std::atoi(argv[++i]);
+        else if (arg == "--busy-poll") config.spinIterations = -1;
+        else
+        {
+            std::cerr << "usage: ik_shmbench [--segment NAME] [--joints N] [--clients N] [--seconds S] [--threads N] [--slots N] [--spin N | --busy-poll]\n";
+            return false;
+        }
+    }
+
+    return config.joints >= 1 && config.clients >= 1 && config.seconds > 0 && config.slots >= 1;
+}
+
+// tracks a target moving around a circle, warm starting every solve from the previous answer like a control loop would
+// the guess is written into the slot and the solution read out of it, so the loop itself copies nothing
+static void runClient(const RingBenchConfig& config, int index, std::vector<double>& latencies, long long& failures)
+{
+    using Clock = std::chrono::steady_clock;
+
+    RingWait wait;
+    wait.spinIterations = config.spinIterations;
+    SharedRingClient client(wait);
+    if (!client.attach(config.segment)) return;
+
+    std::vector<double> previous(config.joints, 0.1);
+    const double radius = 0.6 * config.joints;
+    double phase = index;
+
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.seconds));
+    RingTicket ticket;
+    while (Clock::now() < end)
+    {
+        while (!client.acquire(ticket)) std::this_thread::yield();
+        std::copy(previous.begin(), previous.end(), ticket.guess);
+
+        phase += 0.01;
+        const Clock::time_point sent = Clock::now();
+        client.submit(ticket, Coord2D(radius * std::cos(phase), radius * std::sin(phase)), 1e-9, true);
+        if (!client.waitFor(ticket)) return;
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+
+        if (ticket.slot->status != static_cast<std::int32_t>(SolveStatus::Converged)) failures++;
+        else std::copy(ticket.solution, ticket.solution + config.joints, previous.begin());
+        client.release(ticket);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    RingBenchConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    int ready[2], done[2]; // solver to parent once the ring is up, parent to solver to stop it
+    if (pipe(ready) != 0 || pipe(done) != 0) return 1;
+
+    pid_t child = fork(); // before any thread exists in this process
+    if (child == 0)
+    {
+        close(ready[0]);
+        close(done[1]);
+
+        RingWait wait;
+        wait.spinIterations = config.spinIterations;
+        SharedRingServer server(std::vector<double>(config.joints, 1.0), config.threads, 8, wait);
+        char started = server.start(config.segment, config.slots) ? 1 : 0;
+        if (write(ready[1], &started, 1) != 1 || !started) _exit(1);
+
+        char stop;
+        while (read(done[0], &stop, 1) < 0) {} // returns at end of file, when the parent closes its end
+        server.stop();
+        _exit(0);
+    }
+    close(ready[1]);
+    close(done[0]);
+
+    char started = 0;
+    if (child < 0 || read(ready[0], &started, 1) != 1 || !started)
+    {
+        std::cerr << "Solver process failed to start\n";
+        return 1;
+    }
+
+    std::vector<std::vector<double>> latencies(config.clients);
+    std::vector<long long> failures(config.clients, 0);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < config.clients; c++) threads.emplace_back(runClient, std::cref(config), c, std::ref(latencies[c]), std::ref(failures[c]));
+    for (std::thread& thread : threads) thread.join();
+
+    close(done[1]);
+    close(ready[0]);
+    waitpid(child, nullptr, 0);
+
+    std::vector<double> all;
+    long long failed = 0;
+    for (int c = 0; c < config.clients; c++)
+    {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        failed += failures[c];
+    }
+    if (all.empty())
+    {
+        std::cerr << "No solves completed\n";
+        return 1;
+    }
+
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all[static_cast<std::size_t>(p * (all.size() - 1))]; };
+    std::printf("%zu solves, %.0f solves/s, %lld not converged\n", all.size(), all.size() / config.seconds, failed);
+    std::printf("round trip us: p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n", percentile(0.50), percentile(0.90), percentile(0.99), all.back());
+    return 0;
+}
@@ -0,0 +1,91 @@
+// SolveDaemon.cpp : serves solve requests from other processes on this machine over a unix domain socket.
+//                   Builds as the ik_daemon target (posix only); runs until SIGINT or SIGTERM.
+
+#include "../include/SolveServer.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+// command line configuration
+struct DaemonConfig
+{
+    ServerConfig server;
+    double statsInterval = 0;   // seconds between stats lines; zero prints only on exit
+};
+
+static bool parseArguments(int argc, char** argv, DaemonConfig& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--socket" && hasValue) config.server.socketPath = argv[++i];
+        else if (arg == "--threads" && hasValue) config.server.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--max-batch" && hasValue) config.server.maxBatch = std::atoi(argv[++i]);
+        else if (arg == "--coalesce-us" && hasValue) config.server.coalesceMicroseconds = std::atof(argv[++i]);
+        else if (arg == "--step-control" && hasValue && parseStepControl(argv[i + 1], config.server.stepControl)) i++;
+        else if (arg == "--jacobian" && hasValue && parseJacobianUpdate(argv[i + 1], config.server.jacobianReuse.mode)) i++;
+        else if (arg == "--refresh-interval" && hasValue) config.server.jacobianReuse.refreshInterval = std::atoi(argv[++i]);
+        else if (arg == "--max-iterations" && hasValue) config.server.termination.maxIterations = std::atoi(argv[++i]);
+        else if (arg == "--max-mechanisms" && hasValue) config.server.maxMechanisms = std::atoi(argv[++i]);
+        else if (arg == "--stats-interval" && hasValue) config.statsInterval = std::atof(argv[++i]);
+        else
+        {
+            std::cerr << "usage: ik_daemon [--socket PATH] [--threads N] [--max-batch N] [--coalesce-us MICROSECONDS] [--step-control full|line-search|trust-region] [--jacobian exact|broyden|chord] [--refresh-interval K] [--max-iterations N] [--max-mechanisms N] [--stats-interval SECONDS]\n";
+            return false;
+        }
+    }
+
+    return config.server.maxBatch >= 1 && config.server.jacobianReuse.refreshInterval >= 1 && config.server.termination.maxIterations >= 1 && config.server.maxMechanisms >= 1 && config.server.coalesceMicroseconds >= 0 && config.statsInterval >= 0;
+}
+
+static void printStats(const ServiceStats& s)
+{
+    std::printf("requests %llu  batches %llu  mean batch %.2f  max batch %u  failures %llu  queue %u (max %u)  mechanisms %u  connections %u  "
+                "latency us p50 %.1f p90 %.1f p99 %.1f max %.1f\n",
+        static_cast<unsigned long long>(s.requests), static_cast<unsigned long long>(s.batches), s.meanBatch, s.maxBatch,
+        static_cast<unsigned long long>(s.failures), s.queueDepth, s.maxQueueDepth, s.mechanisms, s.connections,
+        s.latencyP50, s.latencyP90, s.latencyP99, s.latencyMax);
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    DaemonConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    // blocked before any thread starts, so every thread inherits the mask and only sigtimedwait below sees the signals
+    sigset_t shutdown;
+    sigemptyset(&shutdown);
+    sigaddset(&shutdown, SIGINT);
+    sigaddset(&shutdown, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &shutdown, nullptr);
+
+    SolveServer server(config.server);
+    if (!server.start()) return 1;
+    std::printf("serving on %s\n", config.server.socketPath.c_str());
+    std::fflush(stdout);
+
+    while (true)
+    {
+        if (config.statsInterval <= 0)
+        {
+            int signal;
+            sigwait(&shutdown, &signal);
+            break;
+        }
+
+        timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(config.statsInterval);
+        timeout.tv_nsec = static_cast<long>((config.statsInterval - timeout.tv_sec) * 1e9);
+        if (sigtimedwait(&shutdown, nullptr, &timeout) >= 0) break;
+        printStats(server.stats());
+    }
+
+    server.stop();
+    printStats(server.stats());
+    return 0;
+}
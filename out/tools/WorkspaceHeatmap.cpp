@@ -0,0 +1,223 @@
+// WorkspaceHeatmap.cpp : sweeps a grid over a mechanism's workspace and runs the production seeding + newton solve at every cell.
+//                        Builds as the ik_heatmap target and writes a csv of every cell plus ppm heatmaps of iterations and wall time.
+
+#include "../include/InitialGuess.h"
+#include "../include/ThreadPool.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// command line configuration
+struct HeatmapConfig
+{
+    std::vector<double> links = { 1.0, 1.0 };
+    int resolution = 257;       // grid points per side; odd so the center row and column lie exactly on the axes
+    double extent = 0.0;        // half width of the sweep; zero means 5% past the total reach
+    unsigned threads = 0;       // zero means one per hardware thread
+    std::string outputPrefix = "heatmap";
+    std::string tracePath;      // chrome trace output; needs IK_ENABLE_PROFILING
+    StepControl stepControl = StepControl::Full;
+    JacobianReuse jacobianReuse;
+};
+
+// outcome of the solve at one grid point
+struct CellResult
+{
+    double x = 0, y = 0;
+    bool reachable = false;
+    bool converged = false;
+    int iterations = 0;
+    double seconds = 0;
+    double finalError = 0;
+};
+
+// runs exactly what main() does for a single target
+static CellResult solveCell(MechanismModel* m, IterativeSolver& solver, double x, double y)
+{
+    CellResult cell;
+    cell.x = x;
+    cell.y = y;
+
+    Coord2D desiredPoint(x, y);
+    auto start = std::chrono::steady_clock::now();
+
+    Eigen::VectorXd initialGuess = optimizeInitialGuess(m, desiredPoint);
+    cell.reachable = !m->isOutOfReach(desiredPoint);
+
+    if (cell.reachable)
+    {
+        SolveResult result = solver.newtonSolve(m, initialGuess, desiredPoint, 1e-6, 1e-6);
+
+        cell.iterations = result.iterations;
+        cell.finalError = result.error;
+        cell.converged = result.converged();
+    }
+
+    cell.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return cell;
+}
+
+// maps t in [0, 1] onto a blue - green - yellow - red ramp
+static void colorRamp(double t, unsigned char rgb[3])
+{
+    t = std::clamp(t, 0.0, 1.0);
+    double r = std::clamp(2.0 * t - 0.5, 0.0, 1.0);
+    double g = t < 0.75 ? std::clamp(2.0 * t, 0.0, 1.0) : 4.0 * (1.0 - t);
+    double b = std::clamp(1.0 - 2.0 * t, 0.0, 1.0);
+    rgb[0] = static_cast<unsigned char>(255 * r);
+    rgb[1] = static_cast<unsigned char>(255 * g);
+    rgb[2] = static_cast<unsigned char>(255 * b);
+}
+
+// writes a binary ppm; value() returns the cell's value on a log scale between low and high
+// unreachable cells are light gray and failed solves are black
+template <typename Value>
+static bool writeHeatmap(const std::string& path, const std::vector<CellResult>& cells, int resolution, double low, double high, Value value)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file << "P6\n" << resolution << " " << resolution << "\n255\n";
+
+    double logLow = std::log(low), logHigh = std::log(high);
+    for (const CellResult& cell : cells)
+    {
+        unsigned char rgb[3] = { 200, 200, 200 };
+        if (cell.reachable && !cell.converged)
+        {
+            rgb[0] = rgb[1] = rgb[2] = 0;
+        }
+        else if (cell.reachable)
+        {
+            double v = std::max(value(cell), low);
+            colorRamp(logHigh > logLow ? (std::log(v) - logLow) / (logHigh - logLow) : 0.0, rgb);
+        }
+        file.write(reinterpret_cast<const char*>(rgb), 3);
+    }
+
+    return static_cast<bool>(file);
+}
+
+static bool parseArguments(int argc, char** argv, HeatmapConfig& config)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--links" && hasValue) // comma separated link lengths
+        {
+            config.links.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) config.links.push_back(std::atof(item.c_str()));
+        }
+        else if (arg == "--resolution" && hasValue) config.resolution = std::atoi(argv[++i]);
+        else if (arg == "--extent" && hasValue) config.extent = std::atof(argv[++i]);
+        else if (arg == "--threads" && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--output" && hasValue) config.outputPrefix = argv[++i];
+        else if (arg == "--trace" && hasValue) config.tracePath = argv[++i];
+        else if (arg == "--step-control" && hasValue && parseStepControl(argv[i + 1], config.stepControl)) i++;
+        else if (arg == "--jacobian" && hasValue && parseJacobianUpdate(argv[i + 1], config.jacobianReuse.mode)) i++;
+        else if (arg == "--refresh-interval" && hasValue) config.jacobianReuse.refreshInterval = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "usage: ik_heatmap [--links L1,L2,...] [--resolution N] [--extent HALF_WIDTH] [--threads N] [--output PREFIX] [--trace FILE] [--step-control full|line-search|trust-region] [--jacobian exact|broyden|chord] [--refresh-interval K]\n";
+            return false;
+        }
+    }
+
+    bool positiveLinks = !config.links.empty() && std::all_of(config.links.begin(), config.links.end(), [](double l) { return l > 0.0; });
+    return positiveLinks && config.resolution >= 2 && config.jacobianReuse.refreshInterval >= 1;
+}
+
+int main(int argc, char** argv)
+{
+    HeatmapConfig config;
+    if (!parseArguments(argc, argv, config)) return 1;
+
+    MechanismModel mechanism(config.links);
+    MechanismModel* m = &mechanism;
+
+    double reach = 0.0;
+    for (double l : config.links) reach += l;
+    double extent = config.extent > 0.0 ? config.extent : 1.05 * reach;
+
+    const int n = config.resolution;
+    std::vector<CellResult> cells(static_cast<size_t>(n) * n);
+
+    ThreadPool pool(config.threads);
+    auto start = std::chrono::steady_clock::now();
+
+    // one row per task; row 0 is the top of the image
+    pool.parallelFor(0, n, 1, [&](int rowBegin, int rowEnd) {
+        IterativeSolver solver;
+        solver.setVerbose(false);
+        solver.setStepControl(config.stepControl);
+        solver.setJacobianReuse(config.jacobianReuse);
+
+        for (int row = rowBegin; row < rowEnd; row++)
+        {
+            for (int col = 0; col < n; col++)
+            {
+                // integer numerators make the middle row and column exactly zero so the axis special cases are exercised
+                double x = extent * (2.0 * col - (n - 1)) / (n - 1);
+                double y = extent * ((n - 1) - 2.0 * row) / (n - 1);
+                cells[static_cast<size_t>(row) * n + col] = solveCell(m, solver, x, y);
+            }
+        }
+    });
+
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // csv with one line per cell
+    std::ofstream csv(config.outputPrefix + ".csv");
+    if (!csv)
+    {
+        std::cerr << "Could not open " << config.outputPrefix << ".csv for writing.\n";
+        return 1;
+    }
+    csv << "x,y,reachable,converged,iterations,seconds,final_error\n";
+
+    int reachable = 0, converged = 0;
+    double minSeconds = 1e300, maxSeconds = 0;
+    for (const CellResult& cell : cells)
+    {
+        csv << cell.x << "," << cell.y << "," << cell.reachable << "," << cell.converged << ","
+            << cell.iterations << "," << cell.seconds << "," << cell.finalError << "\n";
+
+        if (!cell.reachable) continue;
+        reachable++;
+        if (cell.converged) converged++;
+        minSeconds = std::min(minSeconds, cell.seconds);
+        maxSeconds = std::max(maxSeconds, cell.seconds);
+    }
+
+    bool written = writeHeatmap(config.outputPrefix + "_iterations.ppm", cells, n, 1.0, 1000.0, [](const CellResult& c) { return static_cast<double>(c.iterations); })
+        && writeHeatmap(config.outputPrefix + "_time.ppm", cells, n, std::max(minSeconds, 1e-9), std::max(maxSeconds, 1e-9), [](const CellResult& c) { return c.seconds; });
+    if (!written)
+    {
+        std::cerr << "Could not write the heatmap images.\n";
+        return 1;
+    }
+
+    if (!config.tracePath.empty())
+    {
+#ifdef IK_ENABLE_PROFILING
+        if (!Profiler::writeChromeTrace(config.tracePath)) std::cerr << "Could not write " << config.tracePath << ".\n";
+#else
+        std::cerr << "Tracing requested but ik_heatmap was built without IK_ENABLE_PROFILING.\n";
+#endif
+    }
+
+    std::printf("%d cells (%d reachable) swept on %u threads in %.2f s; %d converged, %d failed.\n",
+        n * n, reachable, pool.size(), totalSeconds, converged, reachable - converged);
+
+    return 0;
+}